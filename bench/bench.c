@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "bench.h"
+
+#include "logger.h"
+
+static size_t allocationCount = 0;
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+
+#ifdef BENCH_COUNT_ALLOCS
+// Linked with -Wl,--wrap so every allocation made by the core library goes through here
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocationCount++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocationCount++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    allocationCount++;
+    return __real_realloc(ptr, size);
+}
+
+bool Bench_countsAllocations() {
+    return true;
+}
+#else
+bool Bench_countsAllocations() {
+    return false;
+}
+#endif
+
+size_t Bench_allocationCount() {
+    return allocationCount;
+}
+
+uint64_t Bench_random() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return randomState;
+}
+
+void Bench_seed(uint64_t seed) {
+    randomState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+bool Bench_running(BenchContext* ctx) {
+    if (ctx->sampleCount < BENCH_MIN_SAMPLES) return true;
+    return ctx->sampleCount < BENCH_MAX_SAMPLES && ctx->elapsed < BENCH_TIME_BUDGET_NS;
+}
+
+void Bench_start(BenchContext* ctx) {
+    ctx->allocStart = allocationCount;
+    ctx->start = SDL_GetTicksNS();
+}
+
+void Bench_stop(BenchContext* ctx, size_t ops) {
+    Uint64 elapsed = SDL_GetTicksNS() - ctx->start;
+    ctx->allocs += allocationCount - ctx->allocStart;
+    ctx->elapsed += elapsed;
+    ctx->ops += ops;
+    if (ctx->sampleCount < BENCH_MAX_SAMPLES) {
+        ctx->samples[ctx->sampleCount++] = ops > 0 ? (double)elapsed / (double)ops : 0.0;
+    }
+}
+
+static int Bench_compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double Bench_percentile(const double* sorted, int count, double percentile) {
+    if (count == 0) return 0.0;
+    int index = (int)ceil(percentile * count) - 1;
+    if (index < 0) index = 0;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+
+BenchResult Bench_run(const BenchCase* bench, size_t n) {
+    BenchContext ctx = { 0 };
+    Bench_seed(n);
+    bench->func(&ctx, n);
+
+    qsort(ctx.samples, ctx.sampleCount, sizeof(double), Bench_compareDouble);
+    return (BenchResult) {
+        .name = bench->name,
+        .size = n,
+        .samples = ctx.sampleCount,
+        .nsPerOp = ctx.ops > 0 ? (double)ctx.elapsed / (double)ctx.ops : 0.0,
+        .p50 = Bench_percentile(ctx.samples, ctx.sampleCount, 0.50),
+        .p99 = Bench_percentile(ctx.samples, ctx.sampleCount, 0.99),
+        .allocsPerOp = !Bench_countsAllocations() ? -1.0 : ctx.ops > 0 ? (double)ctx.allocs / (double)ctx.ops : 0.0,
+        .failed = ctx.failed
+    };
+}
+
+bool Bench_writeJson(const char* path, const BenchResult* results, size_t count) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        error("Failed to open %s for writing", path);
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        const BenchResult* result = &results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"size\": %zu, \"samples\": %d, \"ns_per_op\": %.3f, \"p50_ns\": %.3f, \"p99_ns\": %.3f, ",
+            result->name, result->size, result->samples, result->nsPerOp, result->p50, result->p99);
+        if (result->allocsPerOp < 0) {
+            fprintf(file, "\"allocs_per_op\": null}");
+        } else {
+            fprintf(file, "\"allocs_per_op\": %.4f}", result->allocsPerOp);
+        }
+        fprintf(file, i + 1 < count ? ",\n" : "\n");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
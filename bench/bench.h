@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define BENCH_MIN_SAMPLES 5
+#define BENCH_MAX_SAMPLES 64
+#define BENCH_TIME_BUDGET_NS 250000000ULL
+#define BENCH_MAX_SIZE 1000000
+
+typedef struct BenchContext BenchContext;
+typedef void (*BenchFunc)(BenchContext* ctx, size_t n);
+
+typedef struct {
+    const char* name;
+    BenchFunc func;
+    size_t maxSize;
+} BenchCase;
+
+typedef struct {
+    const char* name;
+    size_t size;
+    int samples;
+    double nsPerOp;
+    double p50;
+    double p99;
+    // Negative when allocations can't be counted on this platform
+    double allocsPerOp;
+    bool failed;
+} BenchResult;
+
+struct BenchContext {
+    double samples[BENCH_MAX_SAMPLES];
+    int sampleCount;
+    Uint64 elapsed;
+    Uint64 start;
+    size_t allocStart;
+    size_t allocs;
+    size_t ops;
+    // Set by a benchmark whose output is wrong, the suite then exits with a failure
+    bool failed;
+};
+
+/*
+ * A benchmark builds its input, then loops on Bench_running and wraps the measured part of every
+ * sample in Bench_start / Bench_stop, giving the number of operations the sample performed.
+ */
+bool Bench_running(BenchContext* ctx);
+void Bench_start(BenchContext* ctx);
+void Bench_stop(BenchContext* ctx, size_t ops);
+BenchResult Bench_run(const BenchCase* bench, size_t n);
+
+bool Bench_countsAllocations();
+size_t Bench_allocationCount();
+// Deterministic xorshift, every run of the suite sees the same inputs
+uint64_t Bench_random();
+void Bench_seed(uint64_t seed);
+
+bool Bench_writeJson(const char* path, const BenchResult* results, size_t count);
+
+extern const BenchCase benchCases[];
+extern const size_t benchCaseCount;
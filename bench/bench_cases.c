@@ -0,0 +1,750 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "bench.h"
+
+#include "atom.h"
+#include "color.h"
+#include "element.h"
+#include "framebuffer.h"
+#include "geometry.h"
+#include "image_atlas.h"
+#include "layout.h"
+#include "list.h"
+#include "logger.h"
+#include "map.h"
+#include "pixel_kernels.h"
+#include "render_queue.h"
+#include "scaled_image_cache.h"
+#include "string_builder.h"
+#include "style.h"
+#include "utils.h"
+#include "vec.h"
+#include "widget_skin.h"
+#include "worker_pool.h"
+
+// Index and value lookups are O(n) on a List, only this many are timed per sample
+#define BENCH_LOOKUPS 64
+// Side of the surface shape benchmarks draw into
+#define BENCH_CANVAS_SIZE 2048
+
+static volatile uintptr_t benchSink;
+
+static List* Bench_randomList(size_t n) {
+    List* list = List_create();
+    for (size_t i = 0; i < n; i++) {
+        List_push_int(list, (intptr_t)(Bench_random() % (n * 4)) - (intptr_t)n);
+    }
+    return list;
+}
+
+static void Bench_listPush(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        List* list = List_create();
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            List_push_int(list, i);
+        }
+        Bench_stop(ctx, n);
+        List_destroy(list);
+    }
+}
+
+static void Bench_listGet(BenchContext* ctx, size_t n) {
+    List* list = Bench_randomList(n);
+    size_t lookups = n < BENCH_LOOKUPS ? n : BENCH_LOOKUPS;
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < lookups; i++) {
+            benchSink += (uintptr_t)List_get(list, Bench_random() % n);
+        }
+        Bench_stop(ctx, lookups);
+    }
+    List_destroy(list);
+}
+
+static void Bench_listFind(BenchContext* ctx, size_t n) {
+    List* list = List_create();
+    for (size_t i = 0; i < n; i++) {
+        List_push_int(list, i);
+    }
+    size_t lookups = n < BENCH_LOOKUPS ? n : BENCH_LOOKUPS;
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < lookups; i++) {
+            benchSink += List_contains(list, (void*)(intptr_t)(Bench_random() % n), false);
+        }
+        Bench_stop(ctx, lookups);
+    }
+    List_destroy(list);
+}
+
+static void Bench_listRemove(BenchContext* ctx, size_t n) {
+    size_t removals = n < BENCH_LOOKUPS ? n : BENCH_LOOKUPS;
+    while (Bench_running(ctx)) {
+        List* list = List_create();
+        for (size_t i = 0; i < n; i++) {
+            List_push_int(list, i);
+        }
+        Bench_start(ctx);
+        for (size_t i = 0; i < removals; i++) {
+            List_remove(list, (void*)(intptr_t)((i * 7919) % n));
+        }
+        Bench_stop(ctx, removals);
+        List_destroy(list);
+    }
+}
+
+static void Bench_listSort(BenchContext* ctx, size_t n, ListSortType sortType) {
+    while (Bench_running(ctx)) {
+        List* list = Bench_randomList(n);
+        Bench_start(ctx);
+        List_sort(list, sortType);
+        Bench_stop(ctx, n);
+        List_destroy(list);
+    }
+}
+
+static void Bench_listSortBubble(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_BUBBLE);
+}
+
+static void Bench_listSortQuick(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_QUICK);
+}
+
+static void Bench_listSortMerge(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_MERGE);
+}
+
+static void Bench_listSortIntro(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_INTRO);
+}
+
+static void Bench_listSortTim(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_TIM);
+}
+
+static void Bench_listSortRadix(BenchContext* ctx, size_t n) {
+    Bench_listSort(ctx, n, LIST_SORT_TYPE_RADIX);
+}
+
+static void Bench_mapPut(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Map* map = Map_create(false);
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            Map_put(map, (void*)(uintptr_t)(i + 1), (void*)(uintptr_t)i);
+        }
+        Bench_stop(ctx, n);
+        Map_destroy(map);
+    }
+}
+
+static void Bench_mapGet(BenchContext* ctx, size_t n) {
+    Map* map = Map_create(false);
+    for (size_t i = 0; i < n; i++) {
+        Map_put(map, (void*)(uintptr_t)(i + 1), (void*)(uintptr_t)i);
+    }
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            benchSink += (uintptr_t)Map_get(map, (void*)(uintptr_t)(Bench_random() % n + 1));
+        }
+        Bench_stop(ctx, n);
+    }
+    Map_destroy(map);
+}
+
+static void Bench_mapRemove(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Map* map = Map_create(false);
+        for (size_t i = 0; i < n; i++) {
+            Map_put(map, (void*)(uintptr_t)(i + 1), (void*)(uintptr_t)i);
+        }
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            Map_remove(map, (void*)(uintptr_t)(i + 1));
+        }
+        Bench_stop(ctx, n);
+        Map_destroy(map);
+    }
+}
+
+static char** Bench_keys(size_t n) {
+    char** keys = malloc(n * sizeof(char*));
+    char buffer[32];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buffer, sizeof(buffer), "key_%zu", i);
+        keys[i] = Strdup(buffer);
+    }
+    return keys;
+}
+
+static void Bench_freeKeys(char** keys, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        safe_free((void**)&keys[i]);
+    }
+    safe_free((void**)&keys);
+}
+
+static void Bench_mapStringGet(BenchContext* ctx, size_t n) {
+    char** keys = Bench_keys(n);
+    Map* map = Map_create(true);
+    for (size_t i = 0; i < n; i++) {
+        Map_put(map, keys[i], (void*)(uintptr_t)i);
+    }
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            benchSink += (uintptr_t)Map_get(map, keys[Bench_random() % n]);
+        }
+        Bench_stop(ctx, n);
+    }
+    Map_destroy(map);
+    Bench_freeKeys(keys, n);
+}
+
+static void Bench_atomIntern(BenchContext* ctx, size_t n) {
+    char** keys = Bench_keys(n);
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            benchSink += (uintptr_t)Atom_intern(keys[i]);
+        }
+        Bench_stop(ctx, n);
+    }
+    Atom_shutdown();
+    Bench_freeKeys(keys, n);
+}
+
+static void Bench_vecPush(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Vec_int vec;
+        Vec_int_init(&vec);
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            Vec_int_push(&vec, (int)i);
+        }
+        Bench_stop(ctx, n);
+        Vec_int_destroy(&vec);
+    }
+}
+
+static void Bench_stringBuilderAppend(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        StringBuilder* sb = StringBuilder_create(DEFAULT_CAPACITY);
+        for (size_t i = 0; i < n; i++) {
+            StringBuilder_append(sb, "item, ");
+        }
+        char* result = StringBuilder_steal(sb);
+        StringBuilder_destroy(sb);
+        Bench_stop(ctx, n);
+        safe_free((void**)&result);
+    }
+}
+
+static void Bench_stringBuilderFormat(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        StringBuilder* sb = StringBuilder_acquire();
+        for (size_t i = 0; i < n; i++) {
+            StringBuilder_append_format(sb, "%zu:%s ", i, "value");
+        }
+        benchSink += StringBuilder_length(sb);
+        StringBuilder_release(sb);
+        Bench_stop(ctx, n);
+    }
+}
+
+static void Bench_strdup(BenchContext* ctx, size_t n) {
+    char** copies = malloc(n * sizeof(char*));
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            copies[i] = Strdup("a moderately long label string");
+        }
+        Bench_stop(ctx, n);
+        for (size_t i = 0; i < n; i++) {
+            safe_free((void**)&copies[i]);
+        }
+    }
+    safe_free((void**)&copies);
+}
+
+static void Bench_flexLayout(BenchContext* ctx, size_t n) {
+    FlexContainer* container = FlexContainer_new(0, 0, 1920, 1080);
+    List* elements = List_create();
+    for (size_t i = 0; i < n; i++) {
+        Element* element = Element_fromBox(Box_new(10 + i % 50, 10 + i % 30, 0, Position_new(0, 0), NULL, NULL, false), "bench");
+        List_push(elements, element);
+        FlexContainer_addElement(container, element, (float)(i % 3), 1.0f, 0.0f);
+    }
+    FlexContainer_setJustifyContent(container, FLEX_JUSTIFY_SPACE_BETWEEN);
+    FlexContainer_setAlignItems(container, FLEX_ALIGN_CENTER);
+    FlexContainer_setGap(container, 4.0f);
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        FlexContainer_layout(container);
+        Bench_stop(ctx, n);
+    }
+    FlexContainer_destroy(container);
+    Element_destroyList(elements);
+}
+
+// Software renderer drawing into a surface, no window or video driver needed
+static SDL_Renderer* Bench_canvas(SDL_Surface** surface) {
+    *surface = SDL_CreateSurface(BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE, SDL_PIXELFORMAT_RGBA32);
+    if (!*surface) return NULL;
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(*surface);
+    if (!renderer) {
+        SDL_DestroySurface(*surface);
+        *surface = NULL;
+    }
+    return renderer;
+}
+
+// The previous Circle_render, one SDL_RenderPoint per covered pixel, kept as the baseline
+static void Bench_circlePointsDraw(SDL_Renderer* renderer, float centerX, float centerY, int radius) {
+    for (int w = 0; w < radius * 2; w++) {
+        for (int h = 0; h < radius * 2; h++) {
+            int dx = radius - w;
+            int dy = radius - h;
+            if ((dx*dx + dy*dy) <= (radius * radius)) {
+                SDL_RenderPoint(renderer, centerX + dx, centerY + dy);
+            }
+        }
+    }
+}
+
+static void Bench_circle(BenchContext* ctx, size_t n, bool points) {
+    SDL_Surface* surface;
+    SDL_Renderer* renderer = Bench_canvas(&surface);
+    if (!renderer) {
+        error("Failed to create the benchmark canvas: %s", SDL_GetError());
+        return;
+    }
+    const float center = BENCH_CANVAS_SIZE / 2.0f;
+    const int radius = (int)n;
+    Circle* circle = Circle_new(radius, 2, Position_new(center, center), Color_rgb(40, 120, 200), Color_rgb(255, 255, 255));
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        if (points) {
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            Bench_circlePointsDraw(renderer, center, center, radius + 2);
+            SDL_SetRenderDrawColor(renderer, 40, 120, 200, 255);
+            Bench_circlePointsDraw(renderer, center, center, radius);
+        } else {
+            Circle_render(circle, renderer);
+            RenderQueue_flush(RenderQueue_get(renderer));
+        }
+        // Rendering is deferred by SDL, flush so the rasterization itself is measured
+        SDL_FlushRenderer(renderer);
+        Bench_stop(ctx, 1);
+    }
+    Circle_destroy(circle);
+    RenderQueue_destroyAll();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(surface);
+}
+
+static void Bench_circlePoints(BenchContext* ctx, size_t n) {
+    Bench_circle(ctx, n, true);
+}
+
+static void Bench_circleSpans(BenchContext* ctx, size_t n) {
+    Bench_circle(ctx, n, false);
+}
+
+/*
+ * n 200x48 bordered widgets over the canvas: the previous Button_render, a border rect with the fill drawn
+ * over it, or WidgetSkin_draw with its cached nine slices, optionally rounded over a blurred shadow.
+ */
+static void Bench_widgets(BenchContext* ctx, size_t n, bool skins, bool shadowed) {
+    SDL_Surface* surface;
+    SDL_Renderer* renderer = Bench_canvas(&surface);
+    if (!renderer) {
+        error("Failed to create the benchmark canvas: %s", SDL_GetError());
+        return;
+    }
+    WidgetSkinCache* cache = skins ? WidgetSkinCache_create(renderer, NULL) : NULL;
+    RenderQueue* queue = RenderQueue_get(renderer);
+    Color* fill = Color_rgb(220, 220, 220);
+    Color* border = Color_rgb(100, 100, 100);
+    const int borderWidth = 2;
+    const WidgetShadow shadow = { 0, 3, 6, { 0, 0, 0, 90 } };
+    while (Bench_running(ctx)) {
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            const SDL_FRect rect = { (float)(i % 9) * 220.0f, (float)(i / 9 % 40) * 50.0f, 200, 48 };
+            if (skins) {
+                WidgetSkin_draw(renderer, &rect, fill, border, borderWidth, shadowed ? 8 : 0, shadowed ? &shadow : NULL);
+            } else {
+                const SDL_FRect inner = { rect.x + borderWidth, rect.y + borderWidth, rect.w - borderWidth * 2, rect.h - borderWidth * 2 };
+                RenderQueue_fillRect(queue, &rect, border);
+                RenderQueue_fillRect(queue, &inner, fill);
+            }
+        }
+        RenderQueue_flush(queue);
+        SDL_FlushRenderer(renderer);
+        Bench_stop(ctx, n);
+    }
+    Color_destroy(fill);
+    Color_destroy(border);
+    WidgetSkinCache_destroy(cache);
+    RenderQueue_destroyAll();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(surface);
+}
+
+static void Bench_widgetRects(BenchContext* ctx, size_t n) {
+    Bench_widgets(ctx, n, false, false);
+}
+
+static void Bench_widgetSkins(BenchContext* ctx, size_t n) {
+    Bench_widgets(ctx, n, true, false);
+}
+
+static void Bench_widgetShadows(BenchContext* ctx, size_t n) {
+    Bench_widgets(ctx, n, true, true);
+}
+
+typedef enum {
+    BENCH_RASTER_SDL,
+    BENCH_RASTER_KERNELS,
+    BENCH_RASTER_SCALAR
+} BenchRaster;
+
+#define BENCH_GLYPH_MASK_SIZE 256
+
+// White texels with random coverage, like a glyph atlas
+static SDL_Surface* Bench_glyphMask() {
+    SDL_Surface* mask = SDL_CreateSurface(BENCH_GLYPH_MASK_SIZE, BENCH_GLYPH_MASK_SIZE, SDL_PIXELFORMAT_RGBA32);
+    if (!mask) return NULL;
+    for (int y = 0; y < mask->h; y++) {
+        Uint8* row = (Uint8*)mask->pixels + (size_t)y * mask->pitch;
+        for (int x = 0; x < mask->w; x++) {
+            row[x * 4] = row[x * 4 + 1] = row[x * 4 + 2] = 255;
+            row[x * 4 + 3] = (Uint8)(Bench_random() & 0xFF);
+        }
+    }
+    return mask;
+}
+
+/*
+ * n translucent quads blended into a width x height frame: 128x128 colored rects, or 16x24 glyphs
+ * tinted from a mask texture. SDL draws them with its software renderer, the others with Framebuffer.
+ */
+static void Bench_raster(BenchContext* ctx, size_t n, int width, int height, BenchRaster raster, bool glyphs) {
+    SDL_Surface* target = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    Framebuffer* framebuffer = Framebuffer_create(NULL, width, height);
+    SDL_Surface* mask = glyphs ? Bench_glyphMask() : NULL;
+    SDL_Texture* texture = mask && renderer ? SDL_CreateTextureFromSurface(renderer, mask) : NULL;
+    SDL_Vertex* vertices = calloc(n * 4, sizeof(SDL_Vertex));
+    const int* indices = Geometry_quadIndices((int)n);
+    if (!renderer || !framebuffer || (glyphs && !texture) || !vertices || !indices) {
+        error("Failed to set up the raster benchmark: %s", SDL_GetError());
+    } else {
+        if (texture) {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+            Framebuffer_attachSurface(texture, mask, true, false);
+        }
+        const float quadWidth = glyphs ? 16.0f : 128.0f;
+        const float quadHeight = glyphs ? 24.0f : 128.0f;
+        for (size_t i = 0; i < n; i++) {
+            const float x = (float)(Bench_random() % (Uint64)(width - quadWidth));
+            const float y = (float)(Bench_random() % (Uint64)(height - quadHeight));
+            const float u = glyphs ? (float)(Bench_random() % (BENCH_GLYPH_MASK_SIZE - 16)) / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const float v = glyphs ? (float)(Bench_random() % (BENCH_GLYPH_MASK_SIZE - 24)) / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const float du = glyphs ? quadWidth / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const float dv = glyphs ? quadHeight / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const SDL_FColor color = { (float)(Bench_random() % 256) / 255.0f, (float)(Bench_random() % 256) / 255.0f, 0.5f, 0.6f };
+            SDL_Vertex* quad = &vertices[i * 4];
+            quad[0] = (SDL_Vertex){ { x, y }, color, { u, v } };
+            quad[1] = (SDL_Vertex){ { x + quadWidth, y }, color, { u + du, v } };
+            quad[2] = (SDL_Vertex){ { x + quadWidth, y + quadHeight }, color, { u + du, v + dv } };
+            quad[3] = (SDL_Vertex){ { x, y + quadHeight }, color, { u, v + dv } };
+        }
+        if (raster == BENCH_RASTER_SCALAR) {
+            PixelKernels_select(PIXEL_KERNELS_SCALAR);
+        }
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        while (Bench_running(ctx)) {
+            Bench_start(ctx);
+            if (raster == BENCH_RASTER_SDL) {
+                SDL_RenderGeometry(renderer, texture, vertices, (int)n * 4, indices, (int)n * 6);
+                SDL_FlushRenderer(renderer);
+            } else {
+                Framebuffer_drawGeometry(framebuffer, NULL, texture, SDL_BLENDMODE_BLEND, vertices, (int)n * 4, indices, (int)n * 6);
+            }
+            Bench_stop(ctx, n);
+        }
+        PixelKernels_select(PIXEL_KERNELS_AUTO);
+    }
+    free(vertices);
+    if (texture) SDL_DestroyTexture(texture);
+    if (mask) SDL_DestroySurface(mask);
+    Framebuffer_destroy(framebuffer);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (target) SDL_DestroySurface(target);
+}
+
+#define BENCH_RASTER_CASE(name, width, height, raster, glyphs) \
+static void name(BenchContext* ctx, size_t n) { \
+    Bench_raster(ctx, n, width, height, raster, glyphs); \
+}
+
+BENCH_RASTER_CASE(Bench_rectsSdlSmall, 800, 600, BENCH_RASTER_SDL, false)
+BENCH_RASTER_CASE(Bench_rectsKernelsSmall, 800, 600, BENCH_RASTER_KERNELS, false)
+BENCH_RASTER_CASE(Bench_rectsScalarSmall, 800, 600, BENCH_RASTER_SCALAR, false)
+BENCH_RASTER_CASE(Bench_rectsSdl4k, 3840, 2160, BENCH_RASTER_SDL, false)
+BENCH_RASTER_CASE(Bench_rectsKernels4k, 3840, 2160, BENCH_RASTER_KERNELS, false)
+BENCH_RASTER_CASE(Bench_rectsScalar4k, 3840, 2160, BENCH_RASTER_SCALAR, false)
+BENCH_RASTER_CASE(Bench_glyphsSdlSmall, 800, 600, BENCH_RASTER_SDL, true)
+BENCH_RASTER_CASE(Bench_glyphsKernelsSmall, 800, 600, BENCH_RASTER_KERNELS, true)
+BENCH_RASTER_CASE(Bench_glyphsSdl4k, 3840, 2160, BENCH_RASTER_SDL, true)
+BENCH_RASTER_CASE(Bench_glyphsKernels4k, 3840, 2160, BENCH_RASTER_KERNELS, true)
+
+// Draws the list once without workers and once by tiles on fresh framebuffers, the pixels must be identical
+static bool Bench_tilesMatch(const FramebufferDraw* draws, int count, int width, int height, const SDL_Rect* clip, WorkerPool* workers) {
+    Framebuffer* reference = Framebuffer_create(NULL, width, height);
+    Framebuffer* tiled = Framebuffer_create(NULL, width, height);
+    bool match = reference && tiled;
+    if (match) {
+        Framebuffer_drawList(reference, clip, draws, count, NULL);
+        Framebuffer_drawList(tiled, clip, draws, count, workers);
+        for (int y = 0; y < height && match; y++) {
+            const Uint8* expected = (const Uint8*)reference->surface->pixels + (size_t)y * reference->surface->pitch;
+            const Uint8* actual = (const Uint8*)tiled->surface->pixels + (size_t)y * tiled->surface->pitch;
+            if (memcmp(expected, actual, (size_t)width * 4) == 0) continue;
+            int x = 0;
+            while (memcmp(expected + x * 4, actual + x * 4, 4) != 0) x++;
+            error("Tiled rasterization differs from a single thread at (%d, %d): %08X instead of %08X",
+                x, y, *(const Uint32*)(actual + x * 4), *(const Uint32*)(expected + x * 4));
+            match = false;
+        }
+    } else {
+        error("Failed to create the framebuffers to compare tiles");
+    }
+    Framebuffer_destroy(tiled);
+    Framebuffer_destroy(reference);
+    return match;
+}
+
+/*
+ * n draws over a width x height frame rasterized by Framebuffer_drawList on threads threads (0 for every core):
+ * translucent rects, glyph quads tinted from a mask and rotated gradient quads, one draw each.
+ */
+static void Bench_tiles(BenchContext* ctx, size_t n, int width, int height, int threads) {
+    SDL_Surface* target = SDL_CreateSurface(16, 16, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    Framebuffer* framebuffer = Framebuffer_create(NULL, width, height);
+    SDL_Surface* mask = Bench_glyphMask();
+    SDL_Texture* texture = mask && renderer ? SDL_CreateTextureFromSurface(renderer, mask) : NULL;
+    WorkerPool* workers = threads != 1 ? WorkerPool_create(threads) : NULL;
+    SDL_Vertex* vertices = calloc(n * 4, sizeof(SDL_Vertex));
+    FramebufferDraw* draws = calloc(n, sizeof(FramebufferDraw));
+    const int* indices = Geometry_quadIndices(1);
+    if (!framebuffer || !texture || !vertices || !draws || !indices) {
+        error("Failed to set up the tiles benchmark: %s", SDL_GetError());
+    } else {
+        Framebuffer_attachSurface(texture, mask, true, false);
+        for (size_t i = 0; i < n; i++) {
+            const int kind = (int)(i % 3);
+            const float w = kind == 1 ? 16.0f : (float)(Bench_random() % 256 + 16);
+            const float h = kind == 1 ? 24.0f : (float)(Bench_random() % 192 + 16);
+            const float x = (float)(Bench_random() % (uint64_t)(width - w));
+            const float y = (float)(Bench_random() % (uint64_t)(height - h));
+            const float skew = kind == 2 ? w / 4.0f : 0.0f;
+            const float u = kind == 1 ? (float)(Bench_random() % (BENCH_GLYPH_MASK_SIZE - 16)) / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const float v = kind == 1 ? (float)(Bench_random() % (BENCH_GLYPH_MASK_SIZE - 24)) / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const float du = kind == 1 ? w / BENCH_GLYPH_MASK_SIZE : 0.0f, dv = kind == 1 ? h / BENCH_GLYPH_MASK_SIZE : 0.0f;
+            const SDL_FColor color = { (float)(Bench_random() % 256) / 255.0f, 0.5f, 0.5f, 0.6f };
+            const SDL_FColor gradient = kind == 2 ? (SDL_FColor){ 0.1f, 0.2f, 0.9f, 0.8f } : color;
+            SDL_Vertex* quad = &vertices[i * 4];
+            quad[0] = (SDL_Vertex){ { x + skew, y }, color, { u, v } };
+            quad[1] = (SDL_Vertex){ { x + w, y + skew }, color, { u + du, v } };
+            quad[2] = (SDL_Vertex){ { x + w - skew, y + h }, gradient, { u + du, v + dv } };
+            quad[3] = (SDL_Vertex){ { x, y + h - skew }, color, { u, v + dv } };
+            draws[i] = (FramebufferDraw){ kind == 1 ? texture : NULL, SDL_BLENDMODE_BLEND, quad, 4, indices, 6 };
+        }
+        // Tiles must not change a single pixel, also with a clip that cuts through them
+        const SDL_Rect clip = { FRAMEBUFFER_TILE / 2 + 5, FRAMEBUFFER_TILE / 3, width - FRAMEBUFFER_TILE - 11, height - FRAMEBUFFER_TILE - 7 };
+        if (workers && (!Bench_tilesMatch(draws, (int)n, width, height, NULL, workers)
+            || !Bench_tilesMatch(draws, (int)n, width, height, &clip, workers))) {
+            ctx->failed = true;
+        }
+        while (Bench_running(ctx)) {
+            Bench_start(ctx);
+            Framebuffer_drawList(framebuffer, NULL, draws, (int)n, workers);
+            Bench_stop(ctx, n);
+        }
+    }
+    free(draws);
+    free(vertices);
+    WorkerPool_destroy(workers);
+    if (texture) SDL_DestroyTexture(texture);
+    if (mask) SDL_DestroySurface(mask);
+    Framebuffer_destroy(framebuffer);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (target) SDL_DestroySurface(target);
+}
+
+#define BENCH_TILES_CASE(name, width, height, threads) \
+static void name(BenchContext* ctx, size_t n) { \
+    Bench_tiles(ctx, n, width, height, threads); \
+}
+
+BENCH_TILES_CASE(Bench_tiles1080p1, 1920, 1080, 1)
+BENCH_TILES_CASE(Bench_tiles1080p2, 1920, 1080, 2)
+BENCH_TILES_CASE(Bench_tiles1080p4, 1920, 1080, 4)
+BENCH_TILES_CASE(Bench_tiles1080pAll, 1920, 1080, 0)
+BENCH_TILES_CASE(Bench_tiles4k1, 3840, 2160, 1)
+BENCH_TILES_CASE(Bench_tiles4k2, 3840, 2160, 2)
+BENCH_TILES_CASE(Bench_tiles4k4, 3840, 2160, 4)
+BENCH_TILES_CASE(Bench_tiles4kAll, 3840, 2160, 0)
+
+#define BENCH_IMAGE_SIZE 1024
+
+/*
+ * n draws of a 1024x1024 noisy image at 0.4 into an 800x600 Framebuffer, sampling the image itself or
+ * the variant ScaledImageCache picks for that size, looked up on every draw like Image_render does.
+ * Framebuffer samples once per drawn pixel either way, this times the lookup and the smaller footprint.
+ */
+static void Bench_imageScale(BenchContext* ctx, size_t n, bool scaled) {
+    SDL_Surface* target = SDL_CreateSurface(16, 16, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    Framebuffer* framebuffer = Framebuffer_create(NULL, 800, 600);
+    SDL_Surface* pixels = SDL_CreateSurface(BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, SDL_PIXELFORMAT_RGBA32);
+    SDL_Texture* texture = pixels && renderer ? SDL_CreateTextureFromSurface(renderer, pixels) : NULL;
+    ScaledImageCache* cache = scaled && renderer ? ScaledImageCache_create(renderer, NULL) : NULL;
+    const int* indices = Geometry_quadIndices(1);
+    if (!framebuffer || !texture || (scaled && !cache) || !indices) {
+        error("Failed to set up the image scale benchmark: %s", SDL_GetError());
+    } else {
+        for (int y = 0; y < pixels->h; y++) {
+            Uint8* row = (Uint8*)pixels->pixels + (size_t)y * pixels->pitch;
+            for (int x = 0; x < pixels->w; x++) {
+                row[x * 4] = (Uint8)(x ^ y);
+                row[x * 4 + 1] = (Uint8)(Bench_random() & 0xFF);
+                row[x * 4 + 2] = (Uint8)(y * 255 / pixels->h);
+                row[x * 4 + 3] = 255;
+            }
+        }
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
+        Framebuffer_attachSurface(texture, pixels, false, false);
+        const Sprite image = { texture, { 0, 0, BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE } };
+        const float size = BENCH_IMAGE_SIZE * 0.4f;
+        const SDL_FColor white = { 1, 1, 1, 1 };
+        while (Bench_running(ctx)) {
+            Bench_start(ctx);
+            for (size_t i = 0; i < n; i++) {
+                const Sprite sprite = scaled ? ScaledImageCache_find(cache, &image, size, size) : image;
+                float textureWidth, textureHeight;
+                SDL_GetTextureSize(sprite.texture, &textureWidth, &textureHeight);
+                const float u0 = sprite.source.x / textureWidth, v0 = sprite.source.y / textureHeight;
+                const float u1 = (sprite.source.x + sprite.source.w) / textureWidth, v1 = (sprite.source.y + sprite.source.h) / textureHeight;
+                const float x = (float)(i % 4) * 100.0f, y = (float)(i % 3) * 50.0f;
+                const SDL_Vertex quad[4] = {
+                    { { x, y }, white, { u0, v0 } },
+                    { { x + size, y }, white, { u1, v0 } },
+                    { { x + size, y + size }, white, { u1, v1 } },
+                    { { x, y + size }, white, { u0, v1 } }
+                };
+                Framebuffer_drawGeometry(framebuffer, NULL, sprite.texture, SDL_BLENDMODE_BLEND, quad, 4, indices, 6);
+            }
+            Bench_stop(ctx, n);
+        }
+    }
+    ScaledImageCache_destroy(cache);
+    if (texture) SDL_DestroyTexture(texture);
+    if (pixels) SDL_DestroySurface(pixels);
+    Framebuffer_destroy(framebuffer);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (target) SDL_DestroySurface(target);
+}
+
+static void Bench_imageFull(BenchContext* ctx, size_t n) {
+    Bench_imageScale(ctx, n, false);
+}
+
+static void Bench_imageScaled(BenchContext* ctx, size_t n) {
+    Bench_imageScale(ctx, n, true);
+}
+
+// Icon-sized rectangles, a full page is replaced by a new one like ImageAtlas does
+static void Bench_skylinePack(BenchContext* ctx, size_t n) {
+    while (Bench_running(ctx)) {
+        Skyline skyline;
+        Skyline_init(&skyline, IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE);
+        Bench_start(ctx);
+        for (size_t i = 0; i < n; i++) {
+            SDL_Point position;
+            const int width = 8 + (int)(Bench_random() % 57);
+            const int height = 8 + (int)(Bench_random() % 57);
+            if (!Skyline_insert(&skyline, width, height, &position)) {
+                Skyline_destroy(&skyline);
+                Skyline_init(&skyline, IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE);
+                Skyline_insert(&skyline, width, height, &position);
+            }
+            benchSink += (uintptr_t)position.x;
+        }
+        Bench_stop(ctx, n);
+        Skyline_destroy(&skyline);
+    }
+}
+
+const BenchCase benchCases[] = {
+    { "list_push", Bench_listPush, BENCH_MAX_SIZE },
+    { "list_get", Bench_listGet, BENCH_MAX_SIZE },
+    { "list_find", Bench_listFind, BENCH_MAX_SIZE },
+    { "list_remove", Bench_listRemove, BENCH_MAX_SIZE },
+    { "list_sort_bubble", Bench_listSortBubble, 10000 },
+    { "list_sort_quick", Bench_listSortQuick, 100000 },
+    { "list_sort_merge", Bench_listSortMerge, BENCH_MAX_SIZE },
+    { "list_sort_intro", Bench_listSortIntro, BENCH_MAX_SIZE },
+    { "list_sort_tim", Bench_listSortTim, BENCH_MAX_SIZE },
+    { "list_sort_radix", Bench_listSortRadix, BENCH_MAX_SIZE },
+    { "map_put", Bench_mapPut, BENCH_MAX_SIZE },
+    { "map_get", Bench_mapGet, BENCH_MAX_SIZE },
+    { "map_remove", Bench_mapRemove, BENCH_MAX_SIZE },
+    { "map_get_string", Bench_mapStringGet, BENCH_MAX_SIZE },
+    { "atom_intern", Bench_atomIntern, BENCH_MAX_SIZE },
+    { "vec_push", Bench_vecPush, BENCH_MAX_SIZE },
+    { "sb_append", Bench_stringBuilderAppend, BENCH_MAX_SIZE },
+    { "sb_format", Bench_stringBuilderFormat, BENCH_MAX_SIZE },
+    { "strdup", Bench_strdup, BENCH_MAX_SIZE },
+    { "flex_layout", Bench_flexLayout, BENCH_MAX_SIZE },
+    { "circle_points", Bench_circlePoints, 1000 },
+    { "circle_spans", Bench_circleSpans, 1000 },
+    { "skyline_pack", Bench_skylinePack, 100000 },
+    { "rects_sdl_800x600", Bench_rectsSdlSmall, 10000 },
+    { "rects_fb_800x600", Bench_rectsKernelsSmall, 10000 },
+    { "rects_scalar_800x600", Bench_rectsScalarSmall, 10000 },
+    { "rects_sdl_4k", Bench_rectsSdl4k, 10000 },
+    { "rects_fb_4k", Bench_rectsKernels4k, 10000 },
+    { "rects_scalar_4k", Bench_rectsScalar4k, 10000 },
+    { "glyphs_sdl_800x600", Bench_glyphsSdlSmall, 100000 },
+    { "glyphs_fb_800x600", Bench_glyphsKernelsSmall, 100000 },
+    { "glyphs_sdl_4k", Bench_glyphsSdl4k, 100000 },
+    { "glyphs_fb_4k", Bench_glyphsKernels4k, 100000 },
+    { "tiles_1080p_1t", Bench_tiles1080p1, 10000 },
+    { "tiles_1080p_2t", Bench_tiles1080p2, 10000 },
+    { "tiles_1080p_4t", Bench_tiles1080p4, 10000 },
+    { "tiles_1080p_all", Bench_tiles1080pAll, 10000 },
+    { "tiles_4k_1t", Bench_tiles4k1, 10000 },
+    { "tiles_4k_2t", Bench_tiles4k2, 10000 },
+    { "tiles_4k_4t", Bench_tiles4k4, 10000 },
+    { "tiles_4k_all", Bench_tiles4kAll, 10000 },
+    { "image_downscale_full", Bench_imageFull, 100 },
+    { "image_downscale_variant", Bench_imageScaled, 100 },
+    { "widgets_rects", Bench_widgetRects, 1000 },
+    { "widgets_skins", Bench_widgetSkins, 1000 },
+    { "widgets_shadows", Bench_widgetShadows, 1000 },
+};
+
+const size_t benchCaseCount = sizeof(benchCases) / sizeof(benchCases[0]);
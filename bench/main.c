@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "bench.h"
+
+#include "logger.h"
+#include "utils.h"
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--json <file>] [--filter <name>] [--max-size <n>]\n", program);
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = NULL;
+    const char* filter = NULL;
+    size_t maxSize = BENCH_MAX_SIZE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            maxSize = (size_t)strtoull(argv[++i], NULL, 10);
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    size_t capacity = benchCaseCount * 6;
+    BenchResult* results = calloc(capacity, sizeof(BenchResult));
+    if (!results) {
+        error("Failed to allocate memory for benchmark results");
+        return EXIT_FAILURE;
+    }
+    size_t count = 0;
+    size_t failures = 0;
+
+    printf("%-22s %10s %8s %12s %12s %12s %10s\n", "benchmark", "size", "samples", "ns/op", "p50", "p99", "allocs/op");
+    for (size_t i = 0; i < benchCaseCount; i++) {
+        const BenchCase* bench = &benchCases[i];
+        if (filter && !strstr(bench->name, filter)) continue;
+        for (size_t n = 10; n <= maxSize && n <= bench->maxSize; n *= 10) {
+            BenchResult result = Bench_run(bench, n);
+            results[count++] = result;
+            printf("%-22s %10zu %8d %12.2f %12.2f %12.2f ", result.name, result.size, result.samples, result.nsPerOp, result.p50, result.p99);
+            if (result.allocsPerOp < 0) {
+                printf("%10s", "n/a");
+            } else {
+                printf("%10.3f", result.allocsPerOp);
+            }
+            printf("%s\n", result.failed ? " FAILED" : "");
+            fflush(stdout);
+            if (result.failed) failures++;
+        }
+    }
+
+    int status = EXIT_SUCCESS;
+    if (failures > 0) {
+        error("%zu benchmarks produced wrong output", failures);
+        status = EXIT_FAILURE;
+    }
+    if (jsonPath && !Bench_writeJson(jsonPath, results, count)) {
+        status = EXIT_FAILURE;
+    }
+    safe_free((void**)&results);
+    return status;
+}
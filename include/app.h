@@ -15,6 +15,10 @@ struct App {
     List* stack;
     Theme* theme;
     ResourceManager* manager;
+    // Render-time temporaries, reset once the frame has been presented
+    Arena* frameArena;
+    // Persistent window content, only what changed is redrawn
+    Canvas* canvas;
 
     bool running;
     bool frameChanged;
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t used;
+    size_t capacity;
+    _Alignas(ARENA_ALIGNMENT) unsigned char data[];
+};
+
+/*
+ * Linear allocator: allocations are a pointer bump and are all released at once by Arena_reset.
+ * Objects created from an arena (the *_newIn constructors) must never be freed individually.
+ */
+struct Arena {
+    ArenaBlock* blocks;
+    size_t blockSize;
+    size_t used;
+    size_t highWater;
+    size_t resets;
+};
+
+Arena* Arena_create(size_t blockSize);
+void Arena_destroy(Arena* arena);
+// Zeroed memory aligned on ARENA_ALIGNMENT
+void* Arena_alloc(Arena* arena, size_t size);
+char* Arena_strdup(Arena* arena, const char* str);
+void Arena_reset(Arena* arena);
+size_t Arena_highWater(Arena* arena);
+void Arena_logStats(Arena* arena, const char* name);
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define ATOM_CHUNK_SIZE 4096
+#define ATOM_MIN_CAPACITY 64
+
+/*
+ * Interned strings: every distinct string is stored once and lives until Atom_shutdown,
+ * so two atoms are equal exactly when their pointers are, and they can key a pointer Map.
+ */
+Atom Atom_intern(const char* str);
+// Returns the atom of an already interned string, NULL if it was never interned
+Atom Atom_find(const char* str);
+size_t Atom_count();
+size_t Atom_bytes();
+void Atom_shutdown();
+
+INLINE bool Atom_equals(Atom a, Atom b) {
+    return a == b;
+}
@@ -12,6 +12,9 @@ struct Button {
     SDL_FRect rect;
 
     ButtonStyle* style;
+    // Style versions last applied to the label
+    Uint32 styleVersion;
+    Uint32 colorsVersion;
 
     Input* input;
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "utils.h"
+
+/*
+ * Retained window content: frames are composited into a persistent target texture and only the region
+ * damaged since the previous frame (see RenderQueue_damage) is cleared and drawn again. When nothing
+ * changed the frame is neither drawn nor presented. In software mode the frame is rasterized on the CPU into
+ * a Framebuffer whose damaged part is uploaded once per frame.
+ */
+struct Canvas {
+    SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    // Replaces the target texture in software mode
+    Framebuffer* framebuffer;
+    bool software;
+    // Splits the software rasterization into tiles, NULL with a single thread
+    WorkerPool* workers;
+    int width;
+    int height;
+    Color background;
+    // Set when the texture content can't be trusted anymore (creation, resize, lost render targets)
+    bool invalid;
+
+    size_t presented;
+    size_t skipped;
+};
+
+Canvas* Canvas_create(SDL_Renderer* renderer);
+void Canvas_destroy(Canvas* self);
+// Redraws the whole window on the next present
+void Canvas_invalidate(Canvas* self);
+// Rasterizes the frames with the pixel kernels instead of the renderer, frame layers included
+void Canvas_setSoftware(Canvas* self, bool software);
+// Threads rasterizing in software mode, the calling one included, 0 for every logical core
+void Canvas_setThreads(Canvas* self, int threads);
+// Draws the damaged part of the queued commands and presents, returns false when there was nothing to present
+bool Canvas_present(Canvas* self, RenderQueue* queue, const Color* background);
+// Reads the last presented content back, the caller destroys the surface
+SDL_Surface* Canvas_capture(Canvas* self);
+void Canvas_logStats(Canvas* self);
@@ -21,7 +21,7 @@ enum ElementType {
 
 struct Element {
     ElementType type;
-    char* id;
+    Atom id;
     union {
         Button* button;
         Text* text;
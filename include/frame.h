@@ -6,19 +6,48 @@
 #pragma once
 
 #include "Settings.h"
+#include "vec.h"
+
+/*
+ * Content rendered once into its own target texture and composited as a single quad every frame, until
+ * FrameLayer_invalidate asks for it to be rendered again. The depth is the RenderQueue layer of the quad,
+ * which is queued before the frame renders itself: a layer at depth 0 or below ends up under the frame
+ * content, a higher one over it.
+ */
+struct FrameLayer {
+    int depth;
+    void* data;
+    FrameRenderFunc func_render;
+    SDL_Texture* texture;
+    // Pixels of the layer when the RenderQueue rasterizes in software, texture is then its texture
+    Framebuffer* framebuffer;
+    int width;
+    int height;
+    bool invalid;
+
+    size_t renders;
+};
+
+VEC_DEFINE_NAMED(Vec_FrameLayerPtr, FrameLayer*)
 
 struct Frame {
     void* element;
-    char* title;
+    Atom title;
     FrameRenderFunc func_render;
     FrameUpdateFunc func_update;
     FrameFocusFunc func_focus;
     FrameFocusFunc func_unfocus;
     DestroyFunc func_destroy;
+    Vec_FrameLayerPtr layers;
 };
 
 Frame* Frame_new(void* element, FrameRenderFunc func_render,FrameUpdateFunc func_update, FrameFocusFunc func_focus, FrameFocusFunc func_unfocus, DestroyFunc func_destroy);
 void Frame_setTitle(Frame* frame, const char* title);
 void Frame_destroy(Frame* frame);
 void Frame_render(Frame* frame, SDL_Renderer* renderer);
-void Frame_update(Frame* frame);
\ No newline at end of file
+void Frame_update(Frame* frame);
+// The layer belongs to the frame, func_render is called with data whenever the layer is invalid
+FrameLayer* Frame_addLayer(Frame* frame, int depth, FrameRenderFunc func_render, void* data);
+// Renders every layer again on the next frame, for lost render targets
+void Frame_invalidateLayers(Frame* frame);
+void FrameLayer_invalidate(FrameLayer* layer);
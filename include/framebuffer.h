@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "vec.h"
+
+// Texture properties giving the software rasterizer the pixels behind a texture, see Framebuffer_attachSurface
+#define FRAMEBUFFER_SURFACE_PROPERTY "SDLBase.framebuffer.surface"
+#define FRAMEBUFFER_MASK_PROPERTY "SDLBase.framebuffer.mask"
+// Image file the surface is decoded from the first time it is needed, see Framebuffer_attachFile
+#define FRAMEBUFFER_PATH_PROPERTY "SDLBase.framebuffer.path"
+// Texels gathered at once when a textured span isn't a plain row of its texture
+#define FRAMEBUFFER_SPAN 256
+// Side of the tiles Framebuffer_drawList splits the frame into for its workers
+#define FRAMEBUFFER_TILE 64
+
+// Pixels behind a texture, see Framebuffer_attachSurface
+struct FramebufferSource {
+    const SDL_Surface* surface;
+    bool mask;
+    // Texture size, which texture coordinates are relative to, the surface may only cover its top-left part
+    int width;
+    int height;
+};
+
+// Indexed triangles of Framebuffer_drawList, indices are relative to vertices
+struct FramebufferDraw {
+    SDL_Texture* texture;
+    SDL_BlendMode blend;
+    const SDL_Vertex* vertices;
+    int vertexCount;
+    const int* indices;
+    int indexCount;
+};
+
+VEC_DEFINE(FramebufferSource)
+VEC_DEFINE(FramebufferDraw)
+VEC_DEFINE_NAMED(Vec_SDLRect, SDL_Rect)
+
+/*
+ * RGBA32 surface the RenderQueue can rasterize into instead of the renderer, with the pixel kernels of
+ * pixel_kernels.h. Axis-aligned quads (rects, glyphs, images, circle spans) are drawn as spans, other
+ * triangles pixel by pixel. Textures are sampled with nearest filtering from the surface attached to them,
+ * textures without one are skipped. Blend modes other than NONE and BLEND_PREMULTIPLIED draw as BLEND.
+ * The streaming texture receives the pixels once per frame through Framebuffer_upload. It comes from the
+ * TexturePool and can be larger than the surface, only its top-left width x height part is used.
+ */
+struct Framebuffer {
+    SDL_Renderer* renderer;
+    SDL_Surface* surface;
+    // NULL without renderer, for rasterizing only
+    SDL_Texture* texture;
+    int width;
+    int height;
+
+    // Tiles of the last Framebuffer_drawList: tileStarts[t] to tileStarts[t + 1] in tileDraws are the draws over tile t
+    Vec_FramebufferSource sources;
+    Vec_SDLRect drawBounds;
+    Vec_int tileStarts;
+    Vec_int tileDraws;
+};
+
+Framebuffer* Framebuffer_create(SDL_Renderer* renderer, int width, int height);
+void Framebuffer_destroy(Framebuffer* self);
+// Copies color over rect, the whole surface when rect is NULL
+void Framebuffer_fill(Framebuffer* self, const SDL_Rect* rect, SDL_Color color);
+bool Framebuffer_upload(Framebuffer* self, const SDL_Rect* rect);
+// Draws indexed triangles like SDL_RenderGeometry, only touching the pixels inside clip
+void Framebuffer_drawGeometry(Framebuffer* self, const SDL_Rect* clip, SDL_Texture* texture, SDL_BlendMode blend,
+    const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount);
+/*
+ * Draws the list in order within clip, like Framebuffer_drawGeometry for each draw. With workers, the draws are
+ * binned into FRAMEBUFFER_TILE tiles which the workers rasterize in parallel, with the same pixels.
+ */
+void Framebuffer_drawList(Framebuffer* self, const SDL_Rect* clip, const FramebufferDraw* draws, int count, WorkerPool* workers);
+/*
+ * Lets the software rasterizer read texture from surface, which must be RGBA32 and stay in sync with it.
+ * A mask only provides coverage in its alpha channel (glyph atlases). When owned, the surface is destroyed
+ * with the texture.
+ */
+void Framebuffer_attachSurface(SDL_Texture* texture, SDL_Surface* surface, bool mask, bool owned);
+/*
+ * Like attaching the decoded image file at path, but nothing is decoded until the pixels are first read,
+ * so textures only the renderer draws keep no copy of them.
+ */
+void Framebuffer_attachFile(SDL_Texture* texture, const char* path);
+// Pixels behind texture, false when it has none. A file attached to it is decoded and kept on first use.
+bool Framebuffer_source(SDL_Texture* texture, FramebufferSource* source);
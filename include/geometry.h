@@ -6,6 +6,13 @@
 #pragma once
 
 #include "Settings.h"
+#include "vec.h"
+
+#define POLYGON_MIN_CAPACITY 8
+// Sharp corners of the border are cut once the miter gets longer than this many border widths
+#define POLYGON_MITER_LIMIT 2.0f
+
+VEC_DEFINE_NAMED(Vec_SDLVertex, SDL_Vertex)
 
 struct Box {
     Size size;
@@ -14,9 +21,12 @@ struct Box {
     Color* background;
     Color* border_color;
     bool center;
+    Arena* arena;
 };
 
 Box* Box_new(float width, float height, int border_size, Position* position, Color* background, Color* border_color, bool center);
+// The box and everything passed to it belong to the arena, Box_destroy leaves them alone
+Box* Box_newIn(Arena* arena, float width, float height, int border_size, Position* position, Color* background, Color* border_color, bool center);
 void Box_destroy(Box* self);
 void Box_render(Box* self, SDL_Renderer* renderer);
 
@@ -30,14 +40,29 @@ struct Circle {
 
 Circle* Circle_new(int radius, int border_size, Position* center, Color* background, Color* border_color);
 void Circle_destroy(Circle* self);
+// Drawn as horizontal spans, border and background together in a single geometry command
 void Circle_render(Circle* self, SDL_Renderer* renderer);
 
+/*
+ * Filled with an ear clipping triangulation (concave shapes included) and outlined with a mitered quad strip
+ * centered on the edges. Both meshes are cached and only rebuilt when a vertex moved or the border changed.
+ */
 struct Polygon {
     Position** vertices;
     int vertex_count;
+    int capacity;
     Color* background;
     Color* border;
     int border_size;
+
+    Vec_SDLVertex fill;
+    Vec_int fillIndices;
+    Vec_SDLVertex outline;
+    Vec_int outlineIndices;
+    // Vertex positions and border size the meshes were built for
+    SDL_FPoint* tessellated;
+    int tessellatedCount;
+    int tessellatedBorder;
 };
 
 Polygon* Polygon_new(Position** vertices, int vertex_count, int border_size, Color* background, Color* border);
@@ -46,3 +71,8 @@ void Polygon_render(Polygon* self, SDL_Renderer* renderer);
 
 Polygon* Polygon_newEmpty(int border_size, Color* background, Color* border);
 void Polygon_addVertex(Polygon* self, Position* vertex);
+
+// Shared index buffer for count quads laid out as 4 vertices each
+const int* Geometry_quadIndices(int count);
+// Frees the buffers shared by every shape, must run at shutdown
+void Geometry_releaseBuffers();
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "vec.h"
+
+#define GLYPH_ATLAS_INITIAL_SIZE 256
+#define GLYPH_ATLAS_MAX_SIZE 2048
+#define GLYPH_ATLAS_PADDING 1
+#define GLYPH_ATLAS_ASCII 128
+
+// Underline and strikethrough are not rasterized with the glyphs, Text draws them as quads
+#define GLYPH_ATLAS_LINE_STYLES (TTF_STYLE_UNDERLINE | TTF_STYLE_STRIKETHROUGH)
+
+struct Glyph {
+    Uint32 codepoint;
+    SDL_Rect rect;
+    int offsetX;
+    int advance;
+};
+
+VEC_DEFINE(Glyph)
+
+/*
+ * Every glyph of a (font, style) pair rasterized once in white into a shared texture, Text tints it
+ * with vertex colors. A CPU surface mirrors the texture so it can grow without reading the GPU back.
+ * The generation changes whenever existing texture coordinates become invalid (growth or reset).
+ */
+struct GlyphAtlas {
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    TTF_FontStyleFlags style;
+    SDL_Surface* surface;
+    SDL_Texture* texture;
+    Vec_Glyph glyphs;
+    int ascii[GLYPH_ATLAS_ASCII];
+    Map* extended;
+    int shelfX;
+    int shelfY;
+    int shelfHeight;
+    int lineHeight;
+    int ascent;
+    Uint32 generation;
+};
+
+GlyphAtlas* GlyphAtlas_get(SDL_Renderer* renderer, TTF_Font* font, TTF_FontStyleFlags style);
+// Rasterizes the glyph on first use, NULL if the font can't render it
+const Glyph* GlyphAtlas_glyph(GlyphAtlas* atlas, Uint32 codepoint);
+int GlyphAtlas_kerning(GlyphAtlas* atlas, Uint32 previous, Uint32 codepoint);
+// Texture coordinates of an opaque white texel, used for solid quads
+SDL_FPoint GlyphAtlas_whiteTexel(GlyphAtlas* atlas);
+// Glyphs rasterized by every atlas since startup, it stays the same over frames that only draw known text
+size_t GlyphAtlas_rasterizedCount();
+// Destroys every atlas, must run before the fonts and the renderer are destroyed
+void GlyphAtlas_destroyAll();
@@ -9,6 +9,8 @@
 
 struct Image {
     SDL_Texture* texture;
+    // Part of the texture showing the image, an atlas page holds many images
+    SDL_FRect source;
     Position* position;
     Size size;
     float ratio;
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "vec.h"
+
+#define IMAGE_ATLAS_PAGE_SIZE 1024
+// Images with a larger side keep a texture of their own
+#define IMAGE_ATLAS_MAX_IMAGE 256
+// Edge pixels copied around every image, so linear filtering never samples a neighbour
+#define IMAGE_ATLAS_EXTRUDE 1
+
+struct SkylineNode {
+    int x;
+    int y;
+    int width;
+};
+
+VEC_DEFINE(SkylineNode)
+
+/*
+ * Bottom-left skyline packer: the nodes are the top edge of everything packed so far, from left to
+ * right, and a rectangle goes where its bottom ends up the lowest.
+ */
+struct Skyline {
+    int width;
+    int height;
+    Vec_SkylineNode nodes;
+    size_t usedArea;
+};
+
+void Skyline_init(Skyline* self, int width, int height);
+void Skyline_destroy(Skyline* self);
+// Returns false when the rectangle doesn't fit anymore
+bool Skyline_insert(Skyline* self, int width, int height, SDL_Point* position);
+// Area under the skyline that no rectangle uses, it can't be packed anymore
+size_t Skyline_wastedArea(const Skyline* self);
+
+// A texture and the part of it holding an image
+struct Sprite {
+    SDL_Texture* texture;
+    SDL_FRect source;
+};
+
+struct ImageAtlasPage {
+    SDL_Surface* surface;
+    SDL_Texture* texture;
+    Skyline skyline;
+    int images;
+};
+
+VEC_DEFINE_NAMED(Vec_ImageAtlasPagePtr, ImageAtlasPage*)
+
+/*
+ * Small images packed into a few large pages, so that any number of them drawn from one page
+ * end up in the same RenderQueue batch. A CPU surface mirrors every page like in GlyphAtlas.
+ */
+struct ImageAtlas {
+    SDL_Renderer* renderer;
+    Vec_ImageAtlasPagePtr pages;
+    size_t images;
+};
+
+ImageAtlas* ImageAtlas_create(SDL_Renderer* renderer);
+void ImageAtlas_destroy(ImageAtlas* self);
+// Copies image into a page, returns false when it is larger than IMAGE_ATLAS_MAX_IMAGE or couldn't be packed
+bool ImageAtlas_add(ImageAtlas* self, SDL_Surface* image, Sprite* sprite);
+void ImageAtlas_logStats(ImageAtlas* self);
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Settings.h"
+#include "pool.h"
 
 #define MAX_KEY_DOWN 256
 
@@ -14,6 +15,9 @@ struct Input {
     SDL_Scancode lastPressed;
     Map* keyEventHandlers;
     Map* eventHandlers;
+    NodePool handlerPool;
+    int dispatching;
+    bool handlersRemoved;
     Position* mousePos;
     bool mouse_left, mouse_right;
     bool shift, ctrl, alt;
@@ -20,6 +20,9 @@ struct InputBox {
     bool password_mode;
 
     InputBoxStyle* style;
+    // Style versions last applied to the text
+    Uint32 styleVersion;
+    Uint32 colorsVersion;
 
     bool focused;
     bool selected;
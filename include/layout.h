@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Settings.h"
+#include "vec.h"
 
 enum FlexDirection {
     FLEX_DIRECTION_ROW,
@@ -41,8 +42,10 @@ struct FlexItem {
     float height;
 };
 
+VEC_DEFINE(FlexItem)
+
 struct FlexContainer {
-    List* items;
+    Vec_FlexItem items;
     FlexDirection direction;
     FlexJustify justify_content;
     FlexAlign align_items;
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Settings.h"
+#include "pool.h"
 
 struct ListNode {
     ListNode* prev;
@@ -17,6 +18,7 @@ struct ListNode {
 struct List {
     ListNode* head;
     size_t size;
+    NodePool pool;
 };
 
 struct ListIterator {
@@ -29,7 +31,10 @@ struct ListIterator {
 enum ListSortType {
     LIST_SORT_TYPE_BUBBLE,
     LIST_SORT_TYPE_QUICK,
-    LIST_SORT_TYPE_MERGE
+    LIST_SORT_TYPE_MERGE,
+    LIST_SORT_TYPE_INTRO,
+    LIST_SORT_TYPE_TIM,
+    LIST_SORT_TYPE_RADIX
 };
 
 List* List_create();
@@ -38,10 +43,12 @@ void List_destroyWitValues(List* list, void (*destroyValueFunc)(void* value));
 void List_clear(List* list);
 void List_push(List* list, void* value);
 void List_remove(List* list, void* value);
+void List_removeNode(List* list, ListNode* node);
 #define List_popLast(list) List_pop(list, list->size - 1)
 void* List_pop(List* list, size_t index);
 size_t List_size(List* list);
 bool List_empty(List* list);
+NodePoolStats List_poolStats(List* list);
 bool List_contains(List* list, void* value, bool isString);
 void* List_get(List* list, size_t index);
 void* List_getLast(List* list);
@@ -50,16 +57,28 @@ void List_set(List* list, size_t index, void* value);
 char* List_toString(List* list, const char* format, void* (*formatValueFunc)(void* value));
 void List_swap(List* list, size_t index1, size_t index2);
 void List_sort(List* list, ListSortType sortType);
+// Sorts the values in a contiguous copy and writes them back in one pass, stable (timsort)
+void List_sortBy(List* list, CompareFunc cmp, void* ctx);
+// Same as List_sortBy but unstable (introsort), usually faster on random input
+void List_sortUnstableBy(List* list, CompareFunc cmp, void* ctx);
+// Stable LSD radix sort on the integer key returned for each value
+void List_sortByKey(List* list, SortKeyFunc key, void* ctx);
 
+ListIterator ListIterator_of(List* list);
 ListIterator* ListIterator_new(List* list);
 void ListIterator_destroy(ListIterator* iterator);
 bool ListIterator_hasNext(ListIterator* iterator);
 void* ListIterator_next(ListIterator* iterator);
 int ListIterator_index(ListIterator* iterator);
 
-#define List_push_int(list, value) List_push(list, (void*)(long)value)
-#define List_push_decimal(list, value) \
-do { \
-__typeof__(value) _tmp = (value); \
-List_push((list), &_tmp); \
-} while(0)
\ No newline at end of file
+/*
+ * Walks the nodes of a list, node->value holding the element. The next node is read before the body runs,
+ * so the body may remove the current node (List_removeNode) but not the following one.
+ */
+#define LIST_FOREACH(node, list) \
+for (ListNode *node = (list)->head->next, *node##_next = node->next; \
+     node != (list)->head; \
+     node = node##_next, node##_next = node->next)
+
+// Stores the integer in the pointer itself, use a Vec (vec.h) to store values that don't fit in a pointer
+#define List_push_int(list, value) List_push(list, (void*)(intptr_t)(value))
\ No newline at end of file
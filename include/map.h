@@ -6,23 +6,39 @@
 #pragma once
 
 #include "Settings.h"
+#include "pool.h"
+
+#define MAP_MIN_CAPACITY 8
 
 struct MapNode {
     void* key;
     void* value;
     MapNode* next;
     MapNode* prev;
+    uint32_t hash;
+};
+
+// Slot of the open-addressing index. distance is the probe length + 1, 0 meaning the slot is empty.
+struct MapBucket {
+    MapNode* node;
+    uint32_t hash;
+    uint32_t distance;
 };
 
+// Nodes are chained in insertion order for iteration, and indexed by a Robin Hood hash table for lookups.
 struct Map {
     MapNode* root;
     size_t size;
     bool is_key_string;
+    MapBucket* buckets;
+    size_t capacity;
+    NodePool pool;
 };
 
 struct MapIterator {
     MapNode* root;
     MapNode* current;
+    MapNode* next;
 };
 
 Map* Map_create(bool is_key_string);
@@ -34,10 +50,13 @@ MapNode* Map_find(Map* map, void* key);
 bool Map_containsKey(Map* map, void* key);
 bool Map_containsValue(Map* map, void* key);
 void Map_remove(Map* map, void* key);
+void Map_reserve(Map* map, size_t count);
 size_t Map_size(Map* map);
 bool Map_isEmpty(Map* map);
+NodePoolStats Map_poolStats(Map* map);
 char* Map_toString(Map* map, const char* keyFormat, const char* valueFormat, void* (*formatKeyFunc)(void* key), void* (*formatValueFunc)(void* value));
 
+MapIterator MapIterator_of(Map* map);
 MapIterator* MapIterator_new(Map* map);
 void MapIterator_destroy(MapIterator* iterator);
 bool MapIterator_hasNext(MapIterator* iterator);
@@ -45,9 +64,13 @@ void MapIterator_next(MapIterator* iterator);
 void* MapIterator_key(MapIterator* iterator);
 void* MapIterator_value(MapIterator* iterator);
 
-#define Map_put_int(map, key, value) Map_put(map, (void*)key, (void*)value)
-#define Map_put_decimal(map, key, value) \
-do { \
-__typeof__(value) _tmp = (value); \
-Map_put((map), (void*)key, &_tmp); \
-} while(0)
\ No newline at end of file
+/*
+ * Walks the nodes of a map in insertion order. The next node is read before the body runs,
+ * so the body may remove the current key but not the following one.
+ */
+#define MAP_FOREACH(node, map) \
+for (MapNode *node = (map)->root->next, *node##_next = node->next; \
+     node != (map)->root; \
+     node = node##_next, node##_next = node->next)
+
+#define Map_put_int(map, key, value) Map_put(map, (void*)(intptr_t)(key), (void*)(intptr_t)(value))
\ No newline at end of file
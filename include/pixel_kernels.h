@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define PIXEL_KERNELS_X86 1
+#else
+#  define PIXEL_KERNELS_X86 0
+#endif
+
+enum PixelKernelsLevel {
+    PIXEL_KERNELS_AUTO,
+    PIXEL_KERNELS_SCALAR,
+    PIXEL_KERNELS_SSE2,
+    PIXEL_KERNELS_AVX2
+};
+
+/*
+ * Span kernels of the software rasterizer, on RGBA32 pixels. Blending is SDL_BLENDMODE_BLEND with
+ * exact rounding (x / 255 rounded to nearest) so every implementation produces the same bytes:
+ * dst = (src * a + dst * (255 - a)) / 255 on color channels, and a + dst * (255 - a) / 255 on alpha.
+ * Texels are tinted (multiplied) by the given color first.
+ */
+struct PixelKernels {
+    const char* name;
+    // Copies color, alpha included
+    void (*fill)(Uint32* dst, int count, SDL_Color color);
+    void (*blendColor)(Uint32* dst, int count, SDL_Color color);
+    // Only the texel alpha is used, as coverage of color: glyphs rasterized in white
+    void (*blendMask)(Uint32* dst, const Uint32* src, int count, SDL_Color color);
+    void (*blendTexture)(Uint32* dst, const Uint32* src, int count, SDL_Color tint);
+    // Texels already multiplied by their alpha, like the content of a FrameLayer
+    void (*blendPremultiplied)(Uint32* dst, const Uint32* src, int count, SDL_Color tint);
+};
+
+// Kernels selected by PixelKernels_select, the best ones the CPU supports until then
+const PixelKernels* PixelKernels_get();
+// Returns false and keeps the current kernels when the CPU doesn't support level
+bool PixelKernels_select(PixelKernelsLevel level);
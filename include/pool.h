@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define NODE_POOL_MIN_CHUNK 8
+#define NODE_POOL_MAX_CHUNK 1024
+
+struct NodePoolStats {
+    size_t live;        // Blocks currently handed out
+    size_t peak;        // Highest value reached by live
+    size_t allocations; // Blocks handed out since creation
+    size_t chunks;      // Chunk pages malloc'd since creation, the only real allocations
+};
+
+// Fixed-size block allocator: blocks are carved from chunk pages that double in size and recycled through a freelist
+struct NodePool {
+    size_t blockSize;
+    size_t nextChunkBlocks;
+    void* freeList;
+    void* chunks;
+    NodePoolStats stats;
+};
+
+void NodePool_init(NodePool* pool, size_t blockSize);
+void NodePool_release(NodePool* pool);
+void* NodePool_alloc(NodePool* pool);
+void NodePool_free(NodePool* pool, void* block);
+NodePoolStats NodePool_getStats(const NodePool* pool);
+
+NodePoolStats NodePool_getGlobalStats();
+void NodePool_logGlobalStats();
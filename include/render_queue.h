@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "framebuffer.h"
+#include "geometry.h"
+#include "vec.h"
+
+// How many batches back a command may move to join one with the same state
+#define RENDER_QUEUE_LOOKBACK 32
+
+struct RenderCommand {
+    int layer;
+    SDL_Texture* texture;
+    SDL_BlendMode blend;
+    SDL_FRect bounds;
+    int firstVertex;
+    int vertexCount;
+    int firstIndex;
+    int indexCount;
+    int batch;
+};
+
+struct RenderBatch {
+    int layer;
+    SDL_Texture* texture;
+    SDL_BlendMode blend;
+    SDL_FRect bounds;
+    int commandCount;
+    int indexCount;
+    int vertexCount;
+};
+
+// What a command drew, used to find what changed from one frame to the next
+struct RenderSignature {
+    uint64_t hash;
+    SDL_FRect bounds;
+};
+
+VEC_DEFINE(RenderCommand)
+VEC_DEFINE(RenderBatch)
+VEC_DEFINE(RenderSignature)
+VEC_DEFINE_NAMED(Vec_RenderCommandPtr, RenderCommand*)
+VEC_DEFINE_NAMED(Vec_SDLTexturePtr, SDL_Texture*)
+
+/*
+ * Draws are recorded as indexed triangles (rects become colored quads) and replayed by RenderQueue_flush.
+ * Commands are ordered by layer, then by submission. A command joins an earlier batch with the same
+ * texture and blend mode when nothing submitted in between overlaps it, so the result stays the same
+ * as drawing immediately. Each batch is one SDL_RenderGeometry call.
+ * Everything drawn between two flushes must go through the queue.
+ */
+struct RenderQueue {
+    SDL_Renderer* renderer;
+    int layer;
+    SDL_BlendMode blend;
+    Vec_SDLVertex vertices;
+    Vec_int indices;
+    Vec_RenderCommand commands;
+
+    Vec_RenderCommandPtr order;
+    Vec_RenderBatch batches;
+    Vec_int batchStarts;
+    Vec_SDLVertex batchVertices;
+    Vec_int batchIndices;
+    bool blendKnown;
+    SDL_BlendMode currentBlend;
+
+    Vec_RenderSignature signatures;
+    Vec_RenderSignature previousSignatures;
+    // Damage the commands can't show, such as a target texture drawn again under the same quad
+    SDL_FRect pendingDamage;
+    bool hasPendingDamage;
+
+    // Set when frames are rasterized in software (Canvas_setSoftware)
+    bool software;
+    // While set, flushes rasterize into it instead of drawing with the renderer
+    Framebuffer* target;
+    SDL_Rect targetClip;
+    // With more than one thread, target is rasterized by tiles in parallel (Canvas_setThreads)
+    WorkerPool* workers;
+    Vec_FramebufferDraw draws;
+
+    // Textures replaced while commands still use them, destroyed once those are flushed or discarded
+    Vec_SDLTexturePtr retired;
+
+    // Commands and draw calls of the last flush
+    int lastCommands;
+    int lastDrawCalls;
+};
+
+// Queue of the renderer, created on first use
+RenderQueue* RenderQueue_get(SDL_Renderer* renderer);
+// Layer of the following commands, higher layers are drawn on top
+void RenderQueue_setLayer(RenderQueue* self, int layer);
+// Blend mode of the following untextured commands, textured ones use the blend mode of their texture
+void RenderQueue_setBlendMode(RenderQueue* self, SDL_BlendMode blend);
+void RenderQueue_fillRect(RenderQueue* self, const SDL_FRect* rect, const Color* color);
+void RenderQueue_texture(RenderQueue* self, SDL_Texture* texture, const SDL_FRect* src, const SDL_FRect* dst);
+// Vertices and indices are copied, indices are relative to the given vertices
+void RenderQueue_geometry(RenderQueue* self, SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount);
+void RenderQueue_flush(RenderQueue* self);
+// Makes the following flushes rasterize into target within clip, NULL goes back to the renderer
+void RenderQueue_setTarget(RenderQueue* self, Framebuffer* target, const SDL_Rect* clip);
+// Only replays the commands overlapping clip, the others are dropped
+void RenderQueue_flushClipped(RenderQueue* self, const SDL_FRect* clip);
+// Drops the recorded commands without drawing them
+void RenderQueue_discard(RenderQueue* self);
+// Destroys texture once the commands recorded so far are flushed or discarded
+void RenderQueue_retireTexture(RenderQueue* self, SDL_Texture* texture);
+/*
+ * Compares the recorded commands with the ones recorded when it was last called. Returns true when
+ * anything changed, damage receiving the union of the bounds of what was drawn differently.
+ */
+bool RenderQueue_damage(RenderQueue* self, SDL_FRect* damage);
+// Adds rect to what the next RenderQueue_damage reports, for content changed behind an identical command
+void RenderQueue_invalidate(RenderQueue* self, const SDL_FRect* rect);
+// Destroys every queue, must run before the renderer is destroyed
+void RenderQueue_destroyAll();
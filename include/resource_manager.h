@@ -18,14 +18,32 @@
 struct ResourceManager {
     SDL_Renderer* renderer;
     MIX_Mixer* mixer;
+    // Caches are keyed by the interned filename (atom.h)
     Map* texturesCache;
     Map* fontsCache;
     Map* soundsCache;
+    // Sprite of every image requested through ResourceManager_getSprite
+    Map* spritesCache;
+    // Pages the small images are packed into while atlasImages is set (the default)
+    ImageAtlas* imageAtlas;
+    bool atlasImages;
+    // Downscaled copies of the images drawn much smaller than they are
+    ScaledImageCache* scaledImages;
+    // Button and InputBox backgrounds, packed in the image atlas like the images
+    WidgetSkinCache* widgetSkins;
+    // Laid out text shared by every Text, trimmed to its budget once per frame
+    TextCache* textCache;
+    // Canvas, frame layer and framebuffer textures recycled by size class
+    TexturePool* texturePool;
 };
 
 ResourceManager* ResourceManager_create(SDL_Renderer* renderer, MIX_Mixer* mixer);
 void ResourceManager_destroy(ResourceManager* self);
 SDL_Texture* ResourceManager_getTexture(ResourceManager* self, const char* filename);
+// Small images come from an atlas page, the others from their own texture
+bool ResourceManager_getSprite(ResourceManager* self, const char* filename, Sprite* sprite);
+// Only applies to the images loaded afterwards
+void ResourceManager_setImageAtlas(ResourceManager* self, bool enabled);
 TTF_Font* ResourceManager_getFont(ResourceManager* self, const char* filename, int size);
 MIX_Audio* ResourceManager_getSound(ResourceManager* self, const char* filename);
 
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "image_atlas.h"
+#include "vec.h"
+
+// Images drawn at more than this scale use their own pixels, linear filtering still averages them well
+#define SCALED_IMAGE_MIN_SCALE 0.7071f
+// Smallest variant is 2^(-MAX_LEVEL / 2) of its image
+#define SCALED_IMAGE_MAX_LEVEL 16
+
+// Variant of a part of a texture, levels are half octaves: level k is 2^(-k / 2) of the image on that axis
+struct ScaledImage {
+    SDL_FRect source;
+    int levelX;
+    int levelY;
+    // NULL texture when the variant couldn't be built, the image is drawn from its own pixels
+    Sprite sprite;
+    // Texture of its own instead of an atlas page slot
+    bool owned;
+};
+
+VEC_DEFINE(ScaledImage)
+
+/*
+ * Downscaled copies of images, owned by the ResourceManager. A variant is box filtered once from the
+ * pixels behind the texture (see Framebuffer_source, which decodes a loaded image the first time), at
+ * the closest half octave that is still larger than the drawn size, so linear filtering only shrinks it
+ * a little more. Small variants are packed into the image atlas.
+ */
+struct ScaledImageCache {
+    SDL_Renderer* renderer;
+    ImageAtlas* atlas;
+    // Vec_ScaledImage* of each texture
+    Map* variants;
+    size_t built;
+    size_t packed;
+    size_t failed;
+    size_t hits;
+    size_t bytes;
+};
+
+ScaledImageCache* ScaledImageCache_create(SDL_Renderer* renderer, ImageAtlas* atlas);
+void ScaledImageCache_destroy(ScaledImageCache* self);
+// Cache of the renderer, NULL when it has none
+ScaledImageCache* ScaledImageCache_get(SDL_Renderer* renderer);
+// Sprite to draw image with at width x height, image itself when it isn't shrunk enough or has no pixels to filter
+Sprite ScaledImageCache_find(ScaledImageCache* self, const Sprite* image, float width, float height);
+void ScaledImageCache_logStats(ScaledImageCache* self);
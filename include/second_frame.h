@@ -9,6 +9,8 @@
 
 struct SecondFrame {
     List* elements;
+    // Static background, drawn once into a frame layer
+    Box* background;
     App* app;
     List* numbers;
     Timer* timer;
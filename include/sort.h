@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define SORT_INSERTION_THRESHOLD 16
+#define SORT_MIN_MERGE 64
+
+// Unstable, O(n log n) worst case: quicksort falling back to heapsort when recursion goes too deep
+void Sort_intro(void** items, size_t count, CompareFunc cmp, void* ctx);
+// Stable, O(n) on already sorted or reversed input: natural runs extended by binary insertion then merged
+bool Sort_tim(void** items, size_t count, CompareFunc cmp, void* ctx);
+// Stable LSD radix sort over the 64-bit signed key of each item, 8 bits per pass
+bool Sort_radix(void** items, size_t count, SortKeyFunc key, void* ctx);
@@ -8,6 +8,9 @@
 #include "Settings.h"
 
 #define DEFAULT_CAPACITY 64
+#define STRING_BUILDER_POOL_SIZE 4
+// Pooled builders that grew past this are freed on release instead of being kept around
+#define STRING_BUILDER_POOL_MAX_CAPACITY 16384
 
 struct StringBuilder {
     char* data;
@@ -21,7 +24,17 @@ void StringBuilder_append(StringBuilder* builder, const char* str);
 void StringBuilder_append_char(StringBuilder* builder, char c);
 void StringBuilder_append_int(StringBuilder* builder, int i);
 void StringBuilder_append_format(StringBuilder* builder, const char* format, ...);
+void StringBuilder_appendv(StringBuilder* builder, const char* format, va_list args);
+// Returns a copy of the content, the builder keeps its buffer
 char* StringBuilder_build(StringBuilder* builder);
+// Returns the builder's own buffer without copying and leaves the builder empty, the caller frees it
+char* StringBuilder_steal(StringBuilder* builder);
+// Borrowed pointer to the content, valid until the builder is modified
+const char* StringBuilder_view(StringBuilder* builder);
 void StringBuilder_clear(StringBuilder* builder);
 size_t StringBuilder_length(StringBuilder* builder);
-size_t StringBuilder_capacity(StringBuilder* builder);
\ No newline at end of file
+size_t StringBuilder_capacity(StringBuilder* builder);
+
+// Per-thread pool of cleared builders, release gives the builder back instead of destroying it
+StringBuilder* StringBuilder_acquire();
+void StringBuilder_release(StringBuilder* builder);
\ No newline at end of file
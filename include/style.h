@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Settings.h"
+#include "utils.h"
 
 struct EdgeInsets {
     float top, bottom, left, right;
@@ -17,40 +18,68 @@ struct EdgeInsets {
 EdgeInsets* EdgeInsets_new(float top, float bottom, float left, float right);
 void EdgeInsets_destroy(EdgeInsets* insets);
 
+/*
+ * Every style carries a version, unique across all styles and changed by every setter or touch, so users
+ * of a style only apply it again when it changed. Call the touch function after editing fields in place.
+ */
+
 struct TextStyle {
     TTF_Font* font;
     int size;
     Color* color;
     TTF_FontStyleFlags style;
+    Uint32 version;
 };
 
 TextStyle* TextStyle_new(TTF_Font* font, int size, Color* color, TTF_FontStyleFlags style);
+TextStyle* TextStyle_newIn(Arena* arena, TTF_Font* font, int size, Color* color, TTF_FontStyleFlags style);
 void TextStyle_destroy(TextStyle* style);
 TextStyle* TextStyle_default(ResourceManager* resource_manager);
 TextStyle* TextStyle_defaultFromTheme(Theme* theme, ResourceManager* resource_manager);
+void TextStyle_touch(TextStyle* style);
+// Size of str drawn in this style, from the font metrics without rasterizing anything (see text_measure.h)
+Size TextStyle_measure(const TextStyle* style, const char* str);
+// Bytes of str fitting in width, their width in fitWidth when given
+size_t TextStyle_fit(const TextStyle* style, const char* str, float width, float* fitWidth);
 
 struct FullStyleColors {
     Color* background;
     Color* border;
     Color* text;
+    Uint32 version;
 };
 
 FullStyleColors* FullStyleColors_new(Color* background, Color* border, Color* text);
 void FullStyleColors_destroy(FullStyleColors* colors);
+void FullStyleColors_touch(FullStyleColors* colors);
+
+// Drop shadow under a widget: its shape moved by the offset and blurred over blur pixels, none while color is transparent
+struct WidgetShadow {
+    int offset_x;
+    int offset_y;
+    int blur;
+    Color color;
+};
 
 struct ButtonStyle {
     FullStyleColors* colors;
     int border_width;
+    // Radius of the outer corners, 0 keeps them square
+    int corner_radius;
+    WidgetShadow shadow;
     TTF_Font* text_font;
     TTF_FontStyleFlags text_style;
     int text_size;
     EdgeInsets* paddings;
+    // Only covers the fields above, the colors have their own version
+    Uint32 version;
 };
 
 ButtonStyle* ButtonStyle_new(FullStyleColors* colors, int border_width, TTF_Font* text_font, TTF_FontStyleFlags text_style, int text_size, EdgeInsets* paddings);
 void ButtonStyle_destroy(ButtonStyle* style);
 ButtonStyle* ButtonStyle_default(ResourceManager* resource_manager);
 ButtonStyle* ButtonStyle_defaultFromTheme(Theme* theme, ResourceManager* resource_manager);
+void ButtonStyle_touch(ButtonStyle* style);
 
 struct InputBoxStyle {
     TTF_Font* font;
@@ -58,12 +87,19 @@ struct InputBoxStyle {
     TTF_FontStyleFlags style;
 
     FullStyleColors* colors;
+    int border_width;
+    // Radius of the outer corners, 0 keeps them square
+    int corner_radius;
+    WidgetShadow shadow;
+    // Only covers the fields above, the colors have their own version
+    Uint32 version;
 };
 
 InputBoxStyle* InputBoxStyle_new(TTF_Font* font, int text_size, TTF_FontStyleFlags style, FullStyleColors* colors);
 void InputBoxStyle_destroy(InputBoxStyle* style);
 InputBoxStyle* InputBoxStyle_default(ResourceManager* resource_manager);
 InputBoxStyle* InputBoxStyle_defaultFromTheme(Theme* theme, ResourceManager* resource_manager);
+void InputBoxStyle_touch(InputBoxStyle* style);
 
 struct Theme {
     Color* background;
@@ -7,24 +7,58 @@
 
 #include "Settings.h"
 
+/*
+ * Text draws the glyph quads of a TextRun (text_cache.h) from the atlas of its font and style. The run is
+ * built on the first render, until then the text is only measured. With a shared cache, every Text showing
+ * the same string shares the run and only owns its placed vertices: changing the color only rewrites vertex
+ * colors, moving or resizing only places the run again. Edits of the style are picked up through its
+ * version (see TextStyle_touch).
+ */
 struct Text {
     char* text;
-    SDL_Texture* texture;
     SDL_Renderer* renderer;
     Position* position;
     TextStyle* style;
     bool fromCenter;
     Size size;
     bool custom_size;
+    Arena* arena;
+
+    // Style version and (font, flags) the run was built for, the color only lives in the vertices
+    Uint32 styleVersion;
+    TTF_Font* builtFont;
+    TTF_FontStyleFlags builtFlags;
+
+    TextRun* run;
+    // Cache holding the reference on run, NULL when the run is borrowed or owned
+    TextCache* cache;
+    bool ownsRun;
+    SDL_Vertex* vertices;
+    int quadCount;
+    int quadCapacity;
+    Uint32 placedGeneration;
+    SDL_FPoint placedAt;
+    Size placedSize;
+    bool placed;
 };
 
+// Cache used by every Text built afterwards, set by the ResourceManager. Without one each Text lays out its own run.
+void Text_setSharedCache(TextCache* cache);
+
 Text* Text_new(SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* str);
 Text* Text_newf(SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, ...);
+// Text built in an arena: the string, style and position must come from the same arena, nothing needs to be destroyed
+Text* Text_newfIn(Arena* arena, SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, ...);
 void Text_destroy(Text* self);
 void Text_setString(Text* self, const char* str);
 void Text_setStringf(Text* self, const char* format, ...);
 void Text_setColor(Text* self, Color* color);
+// Only lays the text out again when the font or the flags differ from the current ones
+void Text_setFont(Text* self, TTF_Font* font, int size, TTF_FontStyleFlags flags);
 void Text_setPosition(Text* self, float x, float y);
 void Text_render(Text* self);
+// Measured from the font metrics (TextStyle_measure), nothing is rasterized before the text is drawn
 Size Text_getSize(Text* self);
+// Size str would have in the style of this text, its own string when NULL
+Size Text_measure(Text* self, const char* str);
 void Text_setSize(Text* self, float width, float height);
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+#define TEXT_CACHE_DEFAULT_BUDGET (1024 * 1024)
+
+/*
+ * Glyph quads of a string laid out from (0, 0), 4 points per quad in layout and texCoords.
+ * The color is not part of a run, Text applies it with its vertices.
+ */
+struct TextRun {
+    char* key;
+    GlyphAtlas* atlas;
+    TTF_FontStyleFlags lines;
+    char* text;
+    Arena* arena;
+    // Atlas generation the texture coordinates were computed for
+    Uint32 generation;
+    SDL_FPoint* layout;
+    SDL_FPoint* texCoords;
+    int quadCount;
+    int quadCapacity;
+    Size naturalSize;
+
+    int refCount;
+    size_t bytes;
+    TextRun* prev;
+    TextRun* next;
+};
+
+/*
+ * Runs shared by every Text drawing the same string with the same atlas and line style.
+ * Released runs stay cached in LRU order and are only evicted by TextCache_trim, once per frame,
+ * so a run borrowed without a reference stays valid until the end of the frame.
+ */
+struct TextCache {
+    Map* runs;
+    TextRun unused;
+    size_t bytes;
+    size_t budget;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+};
+
+// Uncached run, allocated from the arena when there is one
+TextRun* TextRun_new(Arena* arena, GlyphAtlas* atlas, TTF_FontStyleFlags lines, const char* str);
+void TextRun_destroy(TextRun* run);
+// Lays the run out again when its atlas moved the glyphs, returns true if it did
+bool TextRun_refresh(TextRun* run);
+// Runs laid out since startup, cached or not
+size_t TextRun_layoutCount();
+
+TextCache* TextCache_create(size_t budget);
+void TextCache_destroy(TextCache* cache);
+// Returns the run for this string with one more reference
+TextRun* TextCache_acquire(TextCache* cache, GlyphAtlas* atlas, TTF_FontStyleFlags lines, const char* str);
+void TextCache_release(TextCache* cache, TextRun* run);
+// Evicts the least recently released runs until the cache fits in its budget
+void TextCache_trim(TextCache* cache);
+void TextCache_logStats(TextCache* cache);
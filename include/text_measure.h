@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+// Strings kept per font, the cache starts over once full
+#define TEXT_MEASURE_MAX_STRINGS 1024
+
+/*
+ * Sizes of strings in a (font, style) pair from the font metrics (TTF_GetStringSize), no glyph is
+ * rasterized. Layout and widget sizing measure through it, and TextRun takes its size from it so that
+ * what was measured is what gets drawn. Underline and strikethrough don't change the size.
+ */
+struct TextMeasure {
+    TTF_Font* font;
+    TTF_FontStyleFlags style;
+    // String -> Size, the key lives in the value
+    Map* sizes;
+};
+
+TextMeasure* TextMeasure_get(TTF_Font* font, TTF_FontStyleFlags style);
+Size TextMeasure_string(TextMeasure* measure, const char* str);
+// Bytes of str fitting in width (TTF_MeasureString), their width in fitWidth when given
+size_t TextMeasure_fit(TextMeasure* measure, const char* str, float width, float* fitWidth);
+void TextMeasure_logStats();
+// Destroys every cache, must run before the fonts are closed
+void TextMeasure_destroyAll();
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "vec.h"
+
+// Smallest side of a size class, the others are the next powers of two
+#define TEXTURE_POOL_MIN_SIZE 64
+// Bytes of released textures kept for reuse, the oldest ones are destroyed past it
+#define TEXTURE_POOL_DEFAULT_BUDGET (64 * 1024 * 1024)
+
+struct PooledTexture {
+    SDL_Texture* texture;
+    SDL_PixelFormat format;
+    SDL_TextureAccess access;
+    int width;
+    int height;
+    size_t bytes;
+};
+
+VEC_DEFINE(PooledTexture)
+
+/*
+ * Render targets and streaming textures recycled instead of destroyed, owned by the ResourceManager.
+ * Sizes are rounded up to power of two classes so a resized canvas or layer usually gets a released
+ * texture back: it is larger than asked, users draw and composite the top-left width x height part.
+ * Acquired textures keep their content, blend and scale modes are for the user to set.
+ */
+struct TexturePool {
+    SDL_Renderer* renderer;
+    int maxSize;
+    // Released textures, oldest first
+    Vec_PooledTexture idle;
+    size_t budget;
+    size_t idleBytes;
+    size_t residentBytes;
+    size_t peakBytes;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+};
+
+TexturePool* TexturePool_create(SDL_Renderer* renderer, size_t budget);
+void TexturePool_destroy(TexturePool* self);
+// Pool of the renderer, NULL when it has none
+TexturePool* TexturePool_get(SDL_Renderer* renderer);
+// Texture of at least width x height from the pool of the renderer, without one a texture of that exact size
+SDL_Texture* TexturePool_acquire(SDL_Renderer* renderer, SDL_PixelFormat format, SDL_TextureAccess access, int width, int height);
+// Gives an acquired texture back to the pool of its renderer, without one it is destroyed
+void TexturePool_release(SDL_Texture* texture);
+void TexturePool_logStats(TexturePool* self);
@@ -22,3 +22,9 @@ void Timer_reset(Timer* self);
 void Timer_pause(Timer* self);
 void Timer_resume(Timer* self);
 Uint32 Timer_getTicks(Timer* self);
+
+// Milliseconds since startup, or the simulated time once the fixed clock is enabled
+Uint64 Timer_now();
+// Every Timer then reads a clock only moved by Timer_advanceClock, for deterministic runs
+void Timer_useFixedClock(Uint64 start);
+void Timer_advanceClock(Uint64 ms);
@@ -19,11 +19,18 @@ typedef enum ListSortType ListSortType;
 typedef enum LogLevel LogLevel;
 
 typedef struct MapNode MapNode;
+typedef struct MapBucket MapBucket;
 typedef struct Map Map;
 typedef struct MapIterator MapIterator;
 
 typedef struct StringBuilder StringBuilder;
 
+typedef struct Arena Arena;
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct NodePool NodePool;
+typedef struct NodePoolStats NodePoolStats;
+
 typedef struct Position Position;
 typedef struct Color Color;
 
@@ -44,6 +51,7 @@ typedef struct InputBoxStyle InputBoxStyle;
 typedef struct Theme Theme;
 
 typedef struct Frame Frame;
+typedef struct FrameLayer FrameLayer;
 
 typedef struct Box Box;
 typedef struct Circle Circle;
@@ -58,12 +66,45 @@ typedef enum FlexJustify FlexJustify;
 typedef enum FlexAlign FlexAlign;
 
 typedef struct Image Image;
+typedef struct Sprite Sprite;
+typedef struct SkylineNode SkylineNode;
+typedef struct Skyline Skyline;
+typedef struct ImageAtlasPage ImageAtlasPage;
+typedef struct ImageAtlas ImageAtlas;
+
+typedef struct Glyph Glyph;
+typedef struct GlyphAtlas GlyphAtlas;
+typedef struct TextRun TextRun;
+typedef struct TextCache TextCache;
+typedef struct TextMeasure TextMeasure;
+
+typedef struct RenderQueue RenderQueue;
+typedef struct RenderCommand RenderCommand;
+typedef struct RenderBatch RenderBatch;
+typedef struct RenderSignature RenderSignature;
+typedef struct Canvas Canvas;
+typedef struct Framebuffer Framebuffer;
+typedef struct PixelKernels PixelKernels;
+typedef enum PixelKernelsLevel PixelKernelsLevel;
+typedef struct FramebufferSource FramebufferSource;
+typedef struct FramebufferDraw FramebufferDraw;
+typedef struct WorkerPool WorkerPool;
+typedef struct TexturePool TexturePool;
+typedef struct PooledTexture PooledTexture;
+typedef struct ScaledImageCache ScaledImageCache;
+typedef struct ScaledImage ScaledImage;
+typedef struct WidgetSkinCache WidgetSkinCache;
+typedef struct WidgetSkin WidgetSkin;
+typedef struct WidgetShadow WidgetShadow;
 
 // Frames
 typedef struct MainFrame MainFrame;
 typedef struct SecondFrame SecondFrame;
 typedef struct LayoutTestFrame LayoutTestFrame;
 
+// Interned string, see atom.h
+typedef const char* Atom;
+
 // Structure who's not used as a pointer elsewhere
 typedef struct {
     float width, height;
@@ -76,4 +117,7 @@ typedef void (*FrameFocusFunc)(void* data);
 typedef void (*FrameUpdateFunc)(void* data);
 typedef void (*FrameRenderFunc)(SDL_Renderer* renderer, void* data);
 
-typedef void (*DestroyFunc)(void* data);
\ No newline at end of file
+typedef void (*DestroyFunc)(void* data);
+
+typedef int (*CompareFunc)(const void* a, const void* b, void* ctx);
+typedef int64_t (*SortKeyFunc)(const void* value, void* ctx);
\ No newline at end of file
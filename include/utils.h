@@ -17,12 +17,15 @@ struct Color {
 
 #define POSITION_NULL Position_new(-1.0f, -1.0f)
 Position* Position_new(float x, float y);
+Position* Position_newIn(Arena* arena, float x, float y);
 void Position_destroy(Position* pos);
 bool Position_isNull(const Position* pos);
 bool Position_equals(const Position* a, const Position* b);
 
 Color* Color_rgb(int r, int g, int b);
 Color* Color_rgba(int r, int g, int b, int a);
+Color* Color_rgbaIn(Arena* arena, int r, int g, int b, int a);
+#define Color_rgbIn(arena, r, g, b) Color_rgbaIn(arena, r, g, b, 255)
 Color* Color_hsv(float h, float s, float v);
 Color* Color_copy(Color* color);
 SDL_Color Color_toSDLColor(Color* color);
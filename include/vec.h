@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "logger.h"
+
+#define VEC_MIN_CAPACITY 8
+
+/*
+ * Typed growable array storing its values contiguously in a single buffer.
+ * VEC_DEFINE(T) declares Vec_T and its Vec_T_* functions, VEC_DEFINE_NAMED is for types
+ * that are not a single identifier (pointers, ...). A zeroed Vec is a valid empty Vec.
+ */
+#define VEC_DEFINE(T) VEC_DEFINE_NAMED(Vec_##T, T)
+
+#define VEC_DEFINE_NAMED(Name, T) \
+typedef struct Name { \
+    T* data; \
+    size_t size; \
+    size_t capacity; \
+} Name; \
+\
+INLINE void Name##_init(Name* self) { \
+    self->data = NULL; \
+    self->size = 0; \
+    self->capacity = 0; \
+} \
+\
+INLINE void Name##_destroy(Name* self) { \
+    free(self->data); \
+    Name##_init(self); \
+} \
+\
+INLINE bool Name##_reserve(Name* self, size_t capacity) { \
+    if (capacity <= self->capacity) return true; \
+    T* data = realloc(self->data, capacity * sizeof(T)); \
+    if (!data) { \
+        error("Failed to reallocate memory for " #Name); \
+        return false; \
+    } \
+    self->data = data; \
+    self->capacity = capacity; \
+    return true; \
+} \
+\
+INLINE bool Name##_push(Name* self, T value) { \
+    if (self->size == self->capacity) { \
+        size_t capacity = self->capacity > 0 ? self->capacity * 2 : VEC_MIN_CAPACITY; \
+        if (!Name##_reserve(self, capacity)) return false; \
+    } \
+    self->data[self->size++] = value; \
+    return true; \
+} \
+\
+INLINE T Name##_pop(Name* self) { \
+    if (self->size == 0) { \
+        error(#Name " is empty"); \
+        return (T){ 0 }; \
+    } \
+    return self->data[--self->size]; \
+} \
+\
+INLINE T* Name##_at(Name* self, size_t index) { \
+    if (index >= self->size) { \
+        error("Index out of bounds"); \
+        return NULL; \
+    } \
+    return &self->data[index]; \
+} \
+\
+INLINE T Name##_get(const Name* self, size_t index) { \
+    assert(index < self->size); \
+    return self->data[index]; \
+} \
+\
+INLINE void Name##_set(Name* self, size_t index, T value) { \
+    if (index >= self->size) { \
+        error("Index out of bounds"); \
+        return; \
+    } \
+    self->data[index] = value; \
+} \
+\
+INLINE T* Name##_last(Name* self) { \
+    return self->size > 0 ? &self->data[self->size - 1] : NULL; \
+} \
+\
+/* O(1), the last value takes the place of the removed one */ \
+INLINE void Name##_swapRemove(Name* self, size_t index) { \
+    if (index >= self->size) { \
+        error("Index out of bounds"); \
+        return; \
+    } \
+    self->data[index] = self->data[--self->size]; \
+} \
+\
+/* O(n), keeps the order of the remaining values */ \
+INLINE void Name##_remove(Name* self, size_t index) { \
+    if (index >= self->size) { \
+        error("Index out of bounds"); \
+        return; \
+    } \
+    memmove(&self->data[index], &self->data[index + 1], (self->size - index - 1) * sizeof(T)); \
+    self->size--; \
+} \
+\
+INLINE void Name##_clear(Name* self) { \
+    self->size = 0; \
+} \
+\
+INLINE size_t Name##_size(const Name* self) { \
+    return self->size; \
+} \
+\
+INLINE bool Name##_empty(const Name* self) { \
+    return self->size == 0; \
+}
+
+VEC_DEFINE(int)
+VEC_DEFINE(float)
+VEC_DEFINE(double)
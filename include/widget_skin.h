@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+#include "image_atlas.h"
+#include "vec.h"
+
+// Samples per pixel side when the corners are rasterized
+#define WIDGET_SKIN_SAMPLES 4
+// Larger borders or radii are clamped, a skin stays a small atlas image
+#define WIDGET_SKIN_MAX_INSET 64
+// Largest shadow blur and offset, also clamped
+#define WIDGET_SKIN_MAX_SHADOW 32
+
+/*
+ * A bordered, optionally rounded rectangle over its drop shadow, rendered once. The widget itself is
+ * (2 * insetX + 1) x (2 * insetY + 1) pixels with the shadow spreading left, top, right and bottom pixels
+ * around it. The corners hold everything that isn't uniform, the middle row and column get stretched.
+ */
+struct WidgetSkin {
+    SDL_Color background;
+    SDL_Color border;
+    int borderWidth;
+    int cornerRadius;
+    SDL_Color shadowColor;
+    int shadowOffsetX;
+    int shadowOffsetY;
+    int shadowBlur;
+    // Widget part of the corners: the border and radius, and the blurred shadow corner once it is offset
+    int insetX;
+    int insetY;
+    // How far the shadow reaches past each side of the widget
+    int left;
+    int top;
+    int right;
+    int bottom;
+    Sprite sprite;
+    // Texture of its own instead of an atlas page slot
+    bool owned;
+};
+
+VEC_DEFINE(WidgetSkin)
+
+/*
+ * Widget backgrounds drawn as nine slices of a cached skin, owned by the ResourceManager. Every pixel is
+ * covered once, by a single batched geometry command, whatever the size of the widget, its corners and
+ * its shadow.
+ */
+struct WidgetSkinCache {
+    SDL_Renderer* renderer;
+    ImageAtlas* atlas;
+    Vec_WidgetSkin skins;
+    size_t draws;
+};
+
+WidgetSkinCache* WidgetSkinCache_create(SDL_Renderer* renderer, ImageAtlas* atlas);
+void WidgetSkinCache_destroy(WidgetSkinCache* self);
+// Cache of the renderer, NULL when it has none
+WidgetSkinCache* WidgetSkinCache_get(SDL_Renderer* renderer);
+void WidgetSkinCache_logStats(WidgetSkinCache* self);
+
+/*
+ * Fills rect with background inside a border of borderWidth pixels drawn within rect, with corners
+ * rounded by cornerRadius, over shadow when given. Without a cache the rect is drawn as plain, non
+ * overlapping rectangles and without shadow.
+ */
+void WidgetSkin_draw(SDL_Renderer* renderer, const SDL_FRect* rect, const Color* background, const Color* border, int borderWidth, int cornerRadius,
+    const WidgetShadow* shadow);
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+
+#pragma once
+
+#include "Settings.h"
+
+// Runs task(data, index) once for every index of a WorkerPool_run call
+typedef void (*WorkerTask)(void* data, int index);
+
+/*
+ * Threads waiting for WorkerPool_run, which hands them the indices one at a time so that slow items
+ * don't hold the others back. The calling thread takes part in the work.
+ */
+struct WorkerPool {
+    SDL_Thread** threads;
+    int threadCount;
+    SDL_Mutex* mutex;
+    SDL_Condition* started;
+    SDL_Condition* finished;
+
+    WorkerTask task;
+    void* data;
+    int count;
+    SDL_AtomicInt next;
+    // Incremented by every run, workers wake up when it changes
+    int generation;
+    int busy;
+    bool quit;
+};
+
+// Pool of threads - 1 workers (with the caller, threads work at once), 0 uses every logical core
+WorkerPool* WorkerPool_create(int threads);
+void WorkerPool_destroy(WorkerPool* self);
+// Threads working on a run, the caller included
+int WorkerPool_size(const WorkerPool* self);
+// Returns once task ran for every index in [0, count), in any order and on any thread. NULL runs them inline
+void WorkerPool_run(WorkerPool* self, int count, WorkerTask task, void* data);
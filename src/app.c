@@ -4,6 +4,8 @@
  */
 #include "app.h"
 
+#include "arena.h"
+#include "canvas.h"
 #include "frame.h"
 #include "logger.h"
 #include "utils.h"
@@ -12,6 +14,16 @@
 #include "resource_manager.h"
 #include "style.h"
 
+static void App_onCanvasLost(Input* input, SDL_Event* event, void* data) {
+    (void)input;
+    (void)event;
+    App* app = data;
+    Canvas_invalidate(app->canvas);
+    LIST_FOREACH(node, app->stack) {
+        Frame_invalidateLayers(node->value);
+    }
+}
+
 App* App_create(SDL_Window* window, SDL_Renderer* renderer, SDL_AudioSpec* audioSpec) {
     App* app = calloc(1, sizeof(App));
     if (!app) {
@@ -42,6 +54,29 @@ App* App_create(SDL_Window* window, SDL_Renderer* renderer, SDL_AudioSpec* audio
         safe_free((void**)&app);
         return NULL;
     }
+    app->frameArena = Arena_create(ARENA_DEFAULT_BLOCK_SIZE);
+    if (!app->frameArena) {
+        error("Failed to create frame Arena for App");
+        ResourceManager_destroy(app->manager);
+        Input_destroy(app->input);
+        List_destroy(app->stack);
+        safe_free((void**)&app);
+        return NULL;
+    }
+    app->canvas = Canvas_create(renderer);
+    if (!app->canvas) {
+        error("Failed to create Canvas for App");
+        Arena_destroy(app->frameArena);
+        ResourceManager_destroy(app->manager);
+        Input_destroy(app->input);
+        List_destroy(app->stack);
+        safe_free((void**)&app);
+        return NULL;
+    }
+    // The window content or the canvas texture itself may be gone, redraw everything
+    Input_addEventHandler(app->input, SDL_EVENT_WINDOW_EXPOSED, App_onCanvasLost, app);
+    Input_addEventHandler(app->input, SDL_EVENT_RENDER_TARGETS_RESET, App_onCanvasLost, app);
+    Input_addEventHandler(app->input, SDL_EVENT_RENDER_DEVICE_RESET, App_onCanvasLost, app);
     app->running = true;
     return app;
 }
@@ -51,6 +86,8 @@ void App_destroy(App* app) {
     Input_destroy(app->input);
     List_destroy(app->stack);
     Theme_destroy(app->theme);
+    Arena_logStats(app->frameArena, "frame");
+    Arena_destroy(app->frameArena);
     safe_free((void**)&app);
 }
 
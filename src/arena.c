@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "arena.h"
+
+#include "logger.h"
+#include "utils.h"
+
+static ArenaBlock* ArenaBlock_new(size_t capacity) {
+    ArenaBlock* block = malloc(sizeof(ArenaBlock) + capacity);
+    if (!block) {
+        error("Failed to allocate memory for ArenaBlock");
+        return NULL;
+    }
+    block->next = NULL;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+Arena* Arena_create(size_t blockSize) {
+    Arena* arena = calloc(1, sizeof(Arena));
+    if (!arena) {
+        error("Failed to allocate memory for Arena");
+        return NULL;
+    }
+    arena->blockSize = blockSize > 0 ? blockSize : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->blocks = ArenaBlock_new(arena->blockSize);
+    if (!arena->blocks) {
+        safe_free((void**)&arena);
+        return NULL;
+    }
+    return arena;
+}
+
+static void Arena_freeBlocks(ArenaBlock* block) {
+    while (block) {
+        ArenaBlock* next = block->next;
+        safe_free((void**)&block);
+        block = next;
+    }
+}
+
+void Arena_destroy(Arena* arena) {
+    if (!arena) return;
+    Arena_freeBlocks(arena->blocks);
+    safe_free((void**)&arena);
+}
+
+void* Arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    ArenaBlock* block = arena->blocks;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > arena->blockSize ? size : arena->blockSize;
+        ArenaBlock* next = ArenaBlock_new(capacity);
+        if (!next) return NULL;
+        next->next = block;
+        arena->blocks = block = next;
+    }
+
+    void* ptr = block->data + block->used;
+    block->used += size;
+    arena->used += size;
+    if (arena->used > arena->highWater) {
+        arena->highWater = arena->used;
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+char* Arena_strdup(Arena* arena, const char* str) {
+    if (!str) return NULL;
+    size_t len = strlen(str);
+    char* copy = Arena_alloc(arena, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len + 1);
+    return copy;
+}
+
+void Arena_reset(Arena* arena) {
+    if (!arena) return;
+    ArenaBlock* block = arena->blocks;
+    if (block && block->next) {
+        // The last cycle overflowed, replace the chain by one block big enough to hold it
+        size_t capacity = arena->blockSize;
+        while (capacity < arena->used) {
+            capacity *= 2;
+        }
+        Arena_freeBlocks(block);
+        arena->blocks = block = ArenaBlock_new(capacity);
+    }
+    if (block) {
+        block->used = 0;
+    }
+    arena->used = 0;
+    arena->resets++;
+}
+
+size_t Arena_highWater(Arena* arena) {
+    if (!arena) return 0;
+    return arena->highWater;
+}
+
+void Arena_logStats(Arena* arena, const char* name) {
+    if (!arena) return;
+    size_t capacity = 0;
+    for (ArenaBlock* block = arena->blocks; block; block = block->next) {
+        capacity += block->capacity;
+    }
+    log_message(LOG_LEVEL_INFO, "Arena %s: high-water mark %zu bytes, capacity %zu bytes, %zu resets",
+        name ? name : "", arena->highWater, capacity, arena->resets);
+}
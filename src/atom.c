@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "atom.h"
+
+#include "logger.h"
+#include "utils.h"
+
+typedef struct AtomChunk AtomChunk;
+
+struct AtomChunk {
+    AtomChunk* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+};
+
+typedef struct {
+    Atom atom;
+    uint32_t hash;
+} AtomSlot;
+
+static struct {
+    AtomSlot* slots;
+    size_t capacity;
+    size_t count;
+    size_t bytes;
+    AtomChunk* chunks;
+} atoms;
+
+static uint32_t Atom_hash(const char* str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Linear probing, returns the slot holding the string or the empty slot where it belongs
+static AtomSlot* Atom_lookup(const char* str, size_t len, uint32_t hash) {
+    const size_t mask = atoms.capacity - 1;
+    size_t i = hash & mask;
+    while (atoms.slots[i].atom) {
+        AtomSlot* slot = &atoms.slots[i];
+        if (slot->hash == hash && strncmp(slot->atom, str, len) == 0 && slot->atom[len] == '\0') {
+            return slot;
+        }
+        i = (i + 1) & mask;
+    }
+    return &atoms.slots[i];
+}
+
+static bool Atom_grow() {
+    size_t capacity = atoms.capacity ? atoms.capacity * 2 : ATOM_MIN_CAPACITY;
+    AtomSlot* slots = calloc(capacity, sizeof(AtomSlot));
+    if (!slots) {
+        error("Failed to allocate memory for Atom table");
+        return false;
+    }
+    AtomSlot* old = atoms.slots;
+    size_t oldCapacity = atoms.capacity;
+    atoms.slots = slots;
+    atoms.capacity = capacity;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (!old[i].atom) continue;
+        size_t j = old[i].hash & (capacity - 1);
+        while (slots[j].atom) {
+            j = (j + 1) & (capacity - 1);
+        }
+        slots[j] = old[i];
+    }
+    safe_free((void**)&old);
+    return true;
+}
+
+static char* Atom_store(const char* str, size_t len) {
+    AtomChunk* chunk = atoms.chunks;
+    if (!chunk || chunk->capacity - chunk->used < len + 1) {
+        size_t capacity = len + 1 > ATOM_CHUNK_SIZE ? len + 1 : ATOM_CHUNK_SIZE;
+        chunk = malloc(sizeof(AtomChunk) + capacity);
+        if (!chunk) {
+            error("Failed to allocate memory for Atom chunk");
+            return NULL;
+        }
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        chunk->next = atoms.chunks;
+        atoms.chunks = chunk;
+    }
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    chunk->used += len + 1;
+    return copy;
+}
+
+Atom Atom_intern(const char* str) {
+    if (!str) return NULL;
+    // Keep the load factor under 3/4 so probe sequences stay short
+    if ((atoms.count + 1) * 4 > atoms.capacity * 3 && !Atom_grow()) {
+        return NULL;
+    }
+    const size_t len = strlen(str);
+    const uint32_t hash = Atom_hash(str, len);
+    AtomSlot* slot = Atom_lookup(str, len, hash);
+    if (slot->atom) {
+        return slot->atom;
+    }
+    char* copy = Atom_store(str, len);
+    if (!copy) return NULL;
+    slot->atom = copy;
+    slot->hash = hash;
+    atoms.count++;
+    atoms.bytes += len + 1;
+    return copy;
+}
+
+Atom Atom_find(const char* str) {
+    if (!str || atoms.count == 0) return NULL;
+    const size_t len = strlen(str);
+    return Atom_lookup(str, len, Atom_hash(str, len))->atom;
+}
+
+size_t Atom_count() {
+    return atoms.count;
+}
+
+size_t Atom_bytes() {
+    return atoms.bytes;
+}
+
+void Atom_shutdown() {
+    log_message(LOG_LEVEL_DEBUG, "Atom table: %zu strings interned, %zu bytes", atoms.count, atoms.bytes);
+    while (atoms.chunks) {
+        AtomChunk* next = atoms.chunks->next;
+        safe_free((void**)&atoms.chunks);
+        atoms.chunks = next;
+    }
+    safe_free((void**)&atoms.slots);
+    atoms.capacity = 0;
+    atoms.count = 0;
+    atoms.bytes = 0;
+}
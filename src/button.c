@@ -10,8 +10,10 @@
 #include "app.h"
 #include "input.h"
 #include "style.h"
+#include "widget_skin.h"
 
 static void Button_checkHover(Input* input, SDL_Event* evt, void* buttonData);
+static void Button_syncStyle(Button* button);
 static void Button_checkPressed(Input* input, SDL_Event* evt, void* buttonData);
 
 Button* Button_new(const App* app, Position* position, ButtonStyle* style, void* parent, const char* label) {
@@ -28,6 +30,8 @@ Button* Button_new(const App* app, Position* position, ButtonStyle* style, void*
     Size size = Text_getSize(button->text);
     button->rect = SDL_CreateRect(position->x, position->y, size.width, size.height);
     button->style = style;
+    button->styleVersion = style->version;
+    button->colorsVersion = style->colors->version;
     button->input = app->input;
     button->hovered = false;
     button->pressed = false;
@@ -58,6 +62,8 @@ Button* Button_newf(const App* app, Position* position, ButtonStyle* style, void
     const float y = position && !Position_isNull(position) ? position->y : 0;
     button->rect = SDL_CreateRect(x, y, size.width, size.height);
     button->style = style;
+    button->styleVersion = style->version;
+    button->colorsVersion = style->colors->version;
     button->input = app->input;
     button->hovered = false;
     button->pressed = false;
@@ -76,22 +82,31 @@ void Button_destroy(Button* button) {
     safe_free((void**)&button);
 }
 
+static void Button_syncStyle(Button* button) {
+    ButtonStyle* style = button->style;
+    if (style->version != button->styleVersion) {
+        button->styleVersion = style->version;
+        Text_setFont(button->text, style->text_font, style->text_size, style->text_style);
+    }
+    if (style->colors->version != button->colorsVersion) {
+        button->colorsVersion = style->colors->version;
+        Text_setColor(button->text, Color_copy(style->colors->text));
+    }
+}
+
 void Button_render(Button* button, SDL_Renderer* renderer) {
 
-    Text_setColor(button->text, Color_copy(button->style->colors->text));
+    Button_syncStyle(button);
 
     Color* border = button->style->colors->border;
     Color* fill = button->style->colors->background;
     int borderWidth = button->style->border_width;
 
     EdgeInsets* paddings = button->style->paddings;
-    SDL_SetRenderDrawColor(renderer, border->r, border->g, border->b, border->a);
     SDL_FRect borderRect = { button->rect.x - borderWidth - paddings->left, button->rect.y - borderWidth - paddings->top, button->rect.w + (borderWidth * 2)+ (paddings->right + paddings->left), button->rect.h + (borderWidth * 2) + (paddings->bottom + paddings->top)};
-    SDL_RenderFillRect(renderer, &borderRect);
+    WidgetSkin_draw(renderer, &borderRect, fill, border, borderWidth, button->style->corner_radius, &button->style->shadow);
 
-    SDL_SetRenderDrawColor(renderer, fill->r, fill->g, fill->b, fill->a);
     SDL_FRect fillRect = { button->rect.x - paddings->left, button->rect.y - paddings->top, button->rect.w + (paddings->right + paddings->left),  button->rect.h + (paddings->bottom + paddings->top)};
-    SDL_RenderFillRect(renderer, &fillRect);
 
     const float textX = fillRect.x + (fillRect.w / 2) - (Text_getSize(button->text).width / 2);
     const float textY = fillRect.y + (fillRect.h / 2) - (Text_getSize(button->text).height / 2);
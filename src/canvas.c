@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "canvas.h"
+
+#include "framebuffer.h"
+#include "logger.h"
+#include "pixel_kernels.h"
+#include "render_queue.h"
+#include "texture_pool.h"
+#include "utils.h"
+#include "worker_pool.h"
+
+Canvas* Canvas_create(SDL_Renderer* renderer) {
+    Canvas* self = calloc(1, sizeof(Canvas));
+    if (!self) {
+        error("Failed to allocate memory for Canvas");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->invalid = true;
+    return self;
+}
+
+void Canvas_destroy(Canvas* self) {
+    if (!self) return;
+    TexturePool_release(self->texture);
+    Framebuffer_destroy(self->framebuffer);
+    Canvas_setThreads(self, 1);
+    safe_free((void**)&self);
+}
+
+void Canvas_invalidate(Canvas* self) {
+    if (!self) return;
+    self->invalid = true;
+}
+
+void Canvas_setSoftware(Canvas* self, bool software) {
+    if (!self || self->software == software) return;
+    self->software = software;
+    RenderQueue* queue = RenderQueue_get(self->renderer);
+    if (queue) {
+        queue->software = software;
+    }
+    // Recreated for the new mode on the next present
+    self->width = 0;
+    self->height = 0;
+    self->invalid = true;
+    if (software) {
+        log_message(LOG_LEVEL_INFO, "Canvas rasterized in software with the %s pixel kernels", PixelKernels_get()->name);
+    }
+}
+
+void Canvas_setThreads(Canvas* self, int threads) {
+    if (!self) return;
+    WorkerPool_destroy(self->workers);
+    self->workers = threads != 1 ? WorkerPool_create(threads) : NULL;
+    RenderQueue* queue = RenderQueue_get(self->renderer);
+    if (queue) {
+        queue->workers = self->workers;
+    }
+    if (self->workers) {
+        log_message(LOG_LEVEL_INFO, "Software rasterization split into %dx%d tiles on %d threads", FRAMEBUFFER_TILE,
+            FRAMEBUFFER_TILE, WorkerPool_size(self->workers));
+    }
+}
+
+static bool Canvas_resize(Canvas* self, int width, int height) {
+    TexturePool_release(self->texture);
+    self->texture = NULL;
+    Framebuffer_destroy(self->framebuffer);
+    self->framebuffer = NULL;
+    if (self->software) {
+        self->framebuffer = Framebuffer_create(self->renderer, width, height);
+        if (!self->framebuffer) return false;
+        SDL_SetTextureBlendMode(self->framebuffer->texture, SDL_BLENDMODE_NONE);
+        self->width = width;
+        self->height = height;
+        self->invalid = true;
+        return true;
+    }
+    self->texture = TexturePool_acquire(self->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!self->texture) {
+        error("Failed to create canvas texture : %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(self->texture, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(self->texture, SDL_SCALEMODE_NEAREST);
+    self->width = width;
+    self->height = height;
+    self->invalid = true;
+    return true;
+}
+
+// Whole pixels covering the damage, one more on each side for filtered texture edges
+static bool Canvas_damageRect(const Canvas* self, SDL_FRect damage, SDL_Rect* rect) {
+    int x0 = (int)floorf(damage.x) - 1;
+    int y0 = (int)floorf(damage.y) - 1;
+    int x1 = (int)ceilf(damage.x + damage.w) + 1;
+    int y1 = (int)ceilf(damage.y + damage.h) + 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > self->width) x1 = self->width;
+    if (y1 > self->height) y1 = self->height;
+    if (x1 <= x0 || y1 <= y0) return false;
+    *rect = (SDL_Rect){ x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+bool Canvas_present(Canvas* self, RenderQueue* queue, const Color* background) {
+    if (!self || !queue || !background) return false;
+    int width, height;
+    if (!SDL_GetCurrentRenderOutputSize(self->renderer, &width, &height)) {
+        error("Failed to get render output size : %s", SDL_GetError());
+        RenderQueue_discard(queue);
+        return false;
+    }
+    const bool ready = self->software ? self->framebuffer != NULL : self->texture != NULL;
+    if ((!ready || width != self->width || height != self->height) && !Canvas_resize(self, width, height)) {
+        RenderQueue_discard(queue);
+        return false;
+    }
+    if (memcmp(&self->background, background, sizeof(Color)) != 0) {
+        self->background = *background;
+        self->invalid = true;
+    }
+
+    // Always compared so the next frame is diffed against this one
+    SDL_FRect damage;
+    bool damaged = RenderQueue_damage(queue, &damage);
+    if (self->invalid) {
+        damage = (SDL_FRect){ 0, 0, (float)self->width, (float)self->height };
+        damaged = true;
+    }
+    SDL_Rect clip;
+    if (!damaged || !Canvas_damageRect(self, damage, &clip)) {
+        RenderQueue_discard(queue);
+        self->skipped++;
+        return false;
+    }
+
+    const SDL_FRect region = { (float)clip.x, (float)clip.y, (float)clip.w, (float)clip.h };
+    // Pooled textures can be larger than the window
+    const SDL_FRect content = { 0, 0, (float)self->width, (float)self->height };
+    if (self->software) {
+        Framebuffer_fill(self->framebuffer, &clip, (SDL_Color){ background->r, background->g, background->b, background->a });
+        RenderQueue_setTarget(queue, self->framebuffer, &clip);
+        RenderQueue_flushClipped(queue, &region);
+        RenderQueue_setTarget(queue, NULL, NULL);
+        Framebuffer_upload(self->framebuffer, &clip);
+        SDL_RenderTexture(self->renderer, self->framebuffer->texture, &content, NULL);
+        SDL_RenderPresent(self->renderer);
+        self->invalid = false;
+        self->presented++;
+        return true;
+    }
+
+    SDL_SetRenderTarget(self->renderer, self->texture);
+    SDL_SetRenderClipRect(self->renderer, &clip);
+    SDL_SetRenderDrawBlendMode(self->renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(self->renderer, background->r, background->g, background->b, background->a);
+    SDL_RenderFillRect(self->renderer, &region);
+    RenderQueue_flushClipped(queue, &region);
+    SDL_SetRenderClipRect(self->renderer, NULL);
+    SDL_SetRenderTarget(self->renderer, NULL);
+
+    SDL_RenderTexture(self->renderer, self->texture, &content, NULL);
+    SDL_RenderPresent(self->renderer);
+    self->invalid = false;
+    self->presented++;
+    return true;
+}
+
+SDL_Surface* Canvas_capture(Canvas* self) {
+    if (!self) return NULL;
+    if (self->software) {
+        return self->framebuffer ? SDL_DuplicateSurface(self->framebuffer->surface) : NULL;
+    }
+    if (!self->texture) return NULL;
+    // The texture keeps the whole frame even when the last frames were skipped
+    const SDL_Rect content = { 0, 0, self->width, self->height };
+    SDL_SetRenderTarget(self->renderer, self->texture);
+    SDL_Surface* surface = SDL_RenderReadPixels(self->renderer, &content);
+    SDL_SetRenderTarget(self->renderer, NULL);
+    if (!surface) {
+        error("Failed to read canvas pixels : %s", SDL_GetError());
+    }
+    return surface;
+}
+
+void Canvas_logStats(Canvas* self) {
+    if (!self) return;
+    log_message(LOG_LEVEL_DEBUG, "Canvas: %zu frames presented, %zu skipped", self->presented, self->skipped);
+}
@@ -4,6 +4,7 @@
  */
 #include "element.h"
 
+#include "atom.h"
 #include "logger.h"
 #include "button.h"
 #include "geometry.h"
@@ -20,7 +21,7 @@ Element* Element_fromButton(Button* button, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_BUTTON;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.button = button;
     return element;
 }
@@ -32,7 +33,7 @@ Element* Element_fromText(Text* text, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_TEXT;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.text = text;
     return element;
 }
@@ -44,7 +45,7 @@ Element* Element_fromInput(InputBox* input, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_INPUT;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.input_box = input;
     return element;
 }
@@ -56,7 +57,7 @@ Element* Element_fromBox(Box* box, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_BOX;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.box = box;
     return element;
 }
@@ -68,7 +69,7 @@ Element* Element_fromCircle(Circle* circle, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_CIRCLE;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.circle = circle;
     return element;
 }
@@ -80,7 +81,7 @@ Element* Element_fromPolygon(Polygon* polygon, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_POLYGON;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.polygon = polygon;
     return element;
 }
@@ -92,7 +93,7 @@ Element* Element_fromImage(Image* image, const char* id) {
         return NULL;
     }
     element->type = ELEMENT_TYPE_IMAGE;
-    element->id = Strdup(id);
+    element->id = Atom_intern(id);
     element->data.image = image;
     return element;
 }
@@ -127,7 +128,6 @@ void Element_destroy(Element* element) {
             break;
     }
 
-    safe_free((void**)&element->id);
     safe_free((void**)&element);
 }
 
@@ -233,51 +233,43 @@ void Element_unfocus(Element* element) {
 
 
 void Element_renderList(List* list, SDL_Renderer* renderer) {
-    ListIterator* iterator = ListIterator_new(list);
-    while (ListIterator_hasNext(iterator)) {
-        Element* element = ListIterator_next(iterator);
+    LIST_FOREACH(node, list) {
+        Element* element = node->value;
         Element_render(element, renderer);
     }
-    ListIterator_destroy(iterator);
 }
 
 void Element_updateList(List* list) {
-    ListIterator* iterator = ListIterator_new(list);
-    while (ListIterator_hasNext(iterator)) {
-        Element* element = ListIterator_next(iterator);
+    LIST_FOREACH(node, list) {
+        Element* element = node->value;
         Element_update(element);
     }
-    ListIterator_destroy(iterator);
 }
 
 void Element_focusList(List* list) {
-    ListIterator* iterator = ListIterator_new(list);
-    while (ListIterator_hasNext(iterator)) {
-        Element* element = ListIterator_next(iterator);
+    LIST_FOREACH(node, list) {
+        Element* element = node->value;
         Element_focus(element);
     }
-    ListIterator_destroy(iterator);
 }
 
 void Element_unfocusList(List* list) {
-    ListIterator* iterator = ListIterator_new(list);
-    while (ListIterator_hasNext(iterator)) {
-        Element* element = ListIterator_next(iterator);
+    LIST_FOREACH(node, list) {
+        Element* element = node->value;
         Element_unfocus(element);
     }
-    ListIterator_destroy(iterator);
 }
 
 Element* Element_getById(List* list, const char* id) {
-    ListIterator* iterator = ListIterator_new(list);
-    while (ListIterator_hasNext(iterator)) {
-        Element* element = ListIterator_next(iterator);
-        if (String_equals(element->id, id)) {
-            ListIterator_destroy(iterator);
+    // A string that was never interned can't be the id of any element
+    Atom atom = Atom_find(id);
+    if (!atom) return NULL;
+    LIST_FOREACH(node, list) {
+        Element* element = node->value;
+        if (element->id == atom) {
             return element;
         }
     }
-    ListIterator_destroy(iterator);
     return NULL;
 }
 
@@ -3,9 +3,19 @@
  * ALl rights reserved
  */
 #include "frame.h"
+
+#include "atom.h"
+#include "framebuffer.h"
 #include "logger.h"
+#include "render_queue.h"
+#include "texture_pool.h"
 #include "utils.h"
 
+static void FrameLayer_destroy(FrameLayer* layer);
+static void FrameLayer_release(FrameLayer* layer);
+static void Frame_refreshLayers(Frame* frame, SDL_Renderer* renderer, RenderQueue* queue);
+static void Frame_compositeLayers(Frame* frame, RenderQueue* queue);
+
 Frame* Frame_new(void* element, FrameRenderFunc func_render,FrameUpdateFunc func_update, FrameFocusFunc func_focus, FrameFocusFunc func_unfocus, DestroyFunc func_destroy) {
     Frame* frame = calloc(1, sizeof(Frame));
     if (!frame) {
@@ -29,11 +39,21 @@ void Frame_destroy(Frame* frame) {
     if (frame->func_destroy && frame->element) {
         frame->func_destroy(frame->element);
     }
+    for (size_t i = 0; i < frame->layers.size; i++) {
+        FrameLayer_destroy(frame->layers.data[i]);
+    }
+    Vec_FrameLayerPtr_destroy(&frame->layers);
     safe_free((void**)&frame);
 }
 
 void Frame_render(Frame* frame, SDL_Renderer* renderer) {
-    if (!frame || !frame->func_render) return;
+    if (!frame) return;
+    if (frame->layers.size > 0) {
+        RenderQueue* queue = RenderQueue_get(renderer);
+        Frame_refreshLayers(frame, renderer, queue);
+        Frame_compositeLayers(frame, queue);
+    }
+    if (!frame->func_render) return;
     frame->func_render(renderer, frame->element);
 }
 
@@ -44,8 +64,127 @@ void Frame_update(Frame* frame) {
 
 void Frame_setTitle(Frame* frame, const char* title) {
     if (!frame) return;
-    safe_free((void**)&frame->title);
-    if (title) {
-        frame->title = Strdup(title);
+    frame->title = Atom_intern(title);
+}
+
+FrameLayer* Frame_addLayer(Frame* frame, int depth, FrameRenderFunc func_render, void* data) {
+    if (!frame || !func_render) return NULL;
+    FrameLayer* layer = calloc(1, sizeof(FrameLayer));
+    if (!layer) {
+        error("Frame_addLayer: failed to allocate memory for FrameLayer");
+        return NULL;
+    }
+    layer->depth = depth;
+    layer->data = data;
+    layer->func_render = func_render;
+    layer->invalid = true;
+    if (!Vec_FrameLayerPtr_push(&frame->layers, layer)) {
+        safe_free((void**)&layer);
+        return NULL;
+    }
+    return layer;
+}
+
+void Frame_invalidateLayers(Frame* frame) {
+    if (!frame) return;
+    for (size_t i = 0; i < frame->layers.size; i++) {
+        FrameLayer_invalidate(frame->layers.data[i]);
     }
-}
\ No newline at end of file
+}
+
+void FrameLayer_invalidate(FrameLayer* layer) {
+    if (!layer) return;
+    layer->invalid = true;
+}
+
+static void FrameLayer_destroy(FrameLayer* layer) {
+    if (!layer) return;
+    log_message(LOG_LEVEL_DEBUG, "Frame layer %d: rendered %zu times", layer->depth, layer->renders);
+    FrameLayer_release(layer);
+    safe_free((void**)&layer);
+}
+
+static void FrameLayer_release(FrameLayer* layer) {
+    if (layer->framebuffer) {
+        Framebuffer_destroy(layer->framebuffer);
+    } else {
+        TexturePool_release(layer->texture);
+    }
+    layer->framebuffer = NULL;
+    layer->texture = NULL;
+}
+
+static bool FrameLayer_resize(FrameLayer* layer, SDL_Renderer* renderer, int width, int height, bool software) {
+    FrameLayer_release(layer);
+    if (software) {
+        layer->framebuffer = Framebuffer_create(renderer, width, height);
+        layer->texture = layer->framebuffer ? layer->framebuffer->texture : NULL;
+    } else {
+        layer->texture = TexturePool_acquire(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    }
+    if (!layer->texture) {
+        error("Failed to create frame layer texture : %s", SDL_GetError());
+        FrameLayer_release(layer);
+        return false;
+    }
+    // Blending into a transparent target leaves premultiplied colors behind
+    SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    SDL_SetTextureScaleMode(layer->texture, SDL_SCALEMODE_NEAREST);
+    layer->width = width;
+    layer->height = height;
+    layer->invalid = true;
+    return true;
+}
+
+// Runs before the frame queues anything, so each flush only holds the commands of its layer
+static void Frame_refreshLayers(Frame* frame, SDL_Renderer* renderer, RenderQueue* queue) {
+    int width, height;
+    if (!SDL_GetCurrentRenderOutputSize(renderer, &width, &height)) {
+        error("Failed to get render output size : %s", SDL_GetError());
+        return;
+    }
+    for (size_t i = 0; i < frame->layers.size; i++) {
+        FrameLayer* layer = frame->layers.data[i];
+        const bool stale = !layer->texture || layer->width != width || layer->height != height || (layer->framebuffer != NULL) != queue->software;
+        if (stale && !FrameLayer_resize(layer, renderer, width, height, queue->software)) {
+            continue;
+        }
+        if (!layer->invalid) continue;
+
+        if (layer->framebuffer) {
+            Framebuffer_fill(layer->framebuffer, NULL, (SDL_Color){ 0, 0, 0, 0 });
+            layer->func_render(renderer, layer->data);
+            RenderQueue_setTarget(queue, layer->framebuffer, NULL);
+            RenderQueue_flush(queue);
+            RenderQueue_setTarget(queue, NULL, NULL);
+            Framebuffer_upload(layer->framebuffer, NULL);
+        } else {
+            SDL_SetRenderTarget(renderer, layer->texture);
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderClear(renderer);
+            layer->func_render(renderer, layer->data);
+            RenderQueue_flush(queue);
+            SDL_SetRenderTarget(renderer, NULL);
+        }
+
+        // The composite quad stays the same, only its texture changed
+        const SDL_FRect bounds = { 0, 0, (float)width, (float)height };
+        RenderQueue_invalidate(queue, &bounds);
+        layer->invalid = false;
+        layer->renders++;
+    }
+}
+
+static void Frame_compositeLayers(Frame* frame, RenderQueue* queue) {
+    const int previousLayer = queue->layer;
+    for (size_t i = 0; i < frame->layers.size; i++) {
+        const FrameLayer* layer = frame->layers.data[i];
+        if (!layer->texture) continue;
+        // The pooled texture can be larger than the layer
+        const SDL_FRect dst = { 0, 0, (float)layer->width, (float)layer->height };
+        RenderQueue_setLayer(queue, layer->depth);
+        RenderQueue_texture(queue, layer->texture, &dst, &dst);
+    }
+    RenderQueue_setLayer(queue, previousLayer);
+}
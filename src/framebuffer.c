@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "framebuffer.h"
+
+#include "logger.h"
+#include "pixel_kernels.h"
+#include "texture_pool.h"
+#include "utils.h"
+#include "worker_pool.h"
+
+Framebuffer* Framebuffer_create(SDL_Renderer* renderer, int width, int height) {
+    Framebuffer* self = calloc(1, sizeof(Framebuffer));
+    if (!self) {
+        error("Failed to allocate memory for Framebuffer");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->width = width;
+    self->height = height;
+    self->surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    if (!self->surface) {
+        error("Failed to create framebuffer surface : %s", SDL_GetError());
+        safe_free((void**)&self);
+        return NULL;
+    }
+    SDL_FillSurfaceRect(self->surface, NULL, 0);
+    if (renderer) {
+        self->texture = TexturePool_acquire(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+        if (!self->texture) {
+            error("Failed to create framebuffer texture : %s", SDL_GetError());
+            SDL_DestroySurface(self->surface);
+            safe_free((void**)&self);
+            return NULL;
+        }
+        SDL_SetTextureScaleMode(self->texture, SDL_SCALEMODE_NEAREST);
+        // Another framebuffer can composite this one
+        Framebuffer_attachSurface(self->texture, self->surface, false, false);
+    }
+    return self;
+}
+
+void Framebuffer_destroy(Framebuffer* self) {
+    if (!self) return;
+    if (self->texture) {
+        // The next user of the texture attaches its own surface
+        Framebuffer_attachSurface(self->texture, NULL, false, false);
+        TexturePool_release(self->texture);
+    }
+    SDL_DestroySurface(self->surface);
+    Vec_FramebufferSource_destroy(&self->sources);
+    Vec_SDLRect_destroy(&self->drawBounds);
+    Vec_int_destroy(&self->tileStarts);
+    Vec_int_destroy(&self->tileDraws);
+    safe_free((void**)&self);
+}
+
+static void Framebuffer_destroySurface(void* userdata, void* value) {
+    (void)userdata;
+    SDL_DestroySurface(value);
+}
+
+void Framebuffer_attachSurface(SDL_Texture* texture, SDL_Surface* surface, bool mask, bool owned) {
+    if (!texture) return;
+    const SDL_PropertiesID properties = SDL_GetTextureProperties(texture);
+    if (!properties) return;
+    if (owned) {
+        SDL_SetPointerPropertyWithCleanup(properties, FRAMEBUFFER_SURFACE_PROPERTY, surface, Framebuffer_destroySurface, NULL);
+    } else {
+        SDL_SetPointerProperty(properties, FRAMEBUFFER_SURFACE_PROPERTY, surface);
+    }
+    SDL_SetBooleanProperty(properties, FRAMEBUFFER_MASK_PROPERTY, mask);
+}
+
+void Framebuffer_attachFile(SDL_Texture* texture, const char* path) {
+    if (!texture || !path) return;
+    const SDL_PropertiesID properties = SDL_GetTextureProperties(texture);
+    if (!properties) return;
+    SDL_SetStringProperty(properties, FRAMEBUFFER_PATH_PROPERTY, path);
+}
+
+// Decodes the attached file once, a failure clears the path so it isn't decoded again every frame
+static const SDL_Surface* Framebuffer_loadFile(SDL_Texture* texture, SDL_PropertiesID properties) {
+    const char* path = SDL_GetStringProperty(properties, FRAMEBUFFER_PATH_PROPERTY, NULL);
+    if (!path) return NULL;
+    SDL_Surface* loaded = IMG_Load(path);
+    SDL_Surface* surface = loaded ? SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32) : NULL;
+    if (loaded) {
+        SDL_DestroySurface(loaded);
+    }
+    if (!surface) {
+        error("Failed to load the pixels of %s : %s", path, SDL_GetError());
+        SDL_ClearProperty(properties, FRAMEBUFFER_PATH_PROPERTY);
+        return NULL;
+    }
+    Framebuffer_attachSurface(texture, surface, false, true);
+    return surface;
+}
+
+bool Framebuffer_source(SDL_Texture* texture, FramebufferSource* source) {
+    const SDL_PropertiesID properties = SDL_GetTextureProperties(texture);
+    if (!properties) return false;
+    const SDL_Surface* surface = SDL_GetPointerProperty(properties, FRAMEBUFFER_SURFACE_PROPERTY, NULL);
+    if (!surface) {
+        surface = Framebuffer_loadFile(texture, properties);
+    }
+    if (!surface || surface->format != SDL_PIXELFORMAT_RGBA32 || surface->w <= 0 || surface->h <= 0) return false;
+    float width, height;
+    if (!SDL_GetTextureSize(texture, &width, &height)) return false;
+    source->surface = surface;
+    source->mask = SDL_GetBooleanProperty(properties, FRAMEBUFFER_MASK_PROPERTY, false);
+    source->width = (int)width;
+    source->height = (int)height;
+    return true;
+}
+
+INLINE Uint32* Framebuffer_row(const SDL_Surface* surface, int y) {
+    return (Uint32*)((Uint8*)surface->pixels + (size_t)y * surface->pitch);
+}
+
+void Framebuffer_fill(Framebuffer* self, const SDL_Rect* rect, SDL_Color color) {
+    if (!self) return;
+    SDL_Rect area = { 0, 0, self->width, self->height };
+    if (rect && !SDL_GetRectIntersection(rect, &area, &area)) return;
+    const PixelKernels* kernels = PixelKernels_get();
+    for (int y = area.y; y < area.y + area.h; y++) {
+        kernels->fill(Framebuffer_row(self->surface, y) + area.x, area.w, color);
+    }
+}
+
+bool Framebuffer_upload(Framebuffer* self, const SDL_Rect* rect) {
+    if (!self || !self->texture) return false;
+    // The pooled texture can be larger than the surface
+    const SDL_Rect whole = { 0, 0, self->width, self->height };
+    if (!rect) {
+        rect = &whole;
+    }
+    const Uint8* pixels = (const Uint8*)self->surface->pixels + (size_t)rect->y * self->surface->pitch + (size_t)rect->x * 4;
+    if (!SDL_UpdateTexture(self->texture, rect, pixels, self->surface->pitch)) {
+        error("Failed to upload framebuffer : %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+static SDL_Color Framebuffer_color(SDL_FColor color) {
+    const float channels[4] = { color.r, color.g, color.b, color.a };
+    Uint8 bytes[4];
+    for (int c = 0; c < 4; c++) {
+        const float value = channels[c] < 0.0f ? 0.0f : channels[c] > 1.0f ? 1.0f : channels[c];
+        bytes[c] = (Uint8)(value * 255.0f + 0.5f);
+    }
+    return (SDL_Color){ bytes[0], bytes[1], bytes[2], bytes[3] };
+}
+
+// Texel of a coordinate normalized to size, clamped to the edges of the limit texels the surface holds
+INLINE int Framebuffer_texel(float coordinate, int size, int limit) {
+    const int texel = (int)floorf(coordinate * (float)size);
+    return texel < 0 ? 0 : texel >= limit ? limit - 1 : texel;
+}
+
+// NONE is the only mode the kernels don't cover, it replaces the pixels by the tinted texels
+static void Framebuffer_copyTexels(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    for (int i = 0; i < count; i++) {
+        const Uint8* t = (const Uint8*)&src[i];
+        Uint8* d = (Uint8*)&dst[i];
+        d[0] = (Uint8)((t[0] * tint.r + 127) / 255);
+        d[1] = (Uint8)((t[1] * tint.g + 127) / 255);
+        d[2] = (Uint8)((t[2] * tint.b + 127) / 255);
+        d[3] = (Uint8)((t[3] * tint.a + 127) / 255);
+    }
+}
+
+static void Framebuffer_colorSpan(Uint32* dst, int count, SDL_BlendMode blend, SDL_Color color) {
+    const PixelKernels* kernels = PixelKernels_get();
+    if (blend == SDL_BLENDMODE_NONE || color.a == 255) {
+        kernels->fill(dst, count, color);
+    } else if (color.a > 0) {
+        kernels->blendColor(dst, count, color);
+    }
+}
+
+static void Framebuffer_texelSpan(Uint32* dst, const Uint32* texels, int count, const FramebufferSource* source, SDL_BlendMode blend, SDL_Color tint) {
+    const PixelKernels* kernels = PixelKernels_get();
+    if (blend == SDL_BLENDMODE_NONE) {
+        Framebuffer_copyTexels(dst, texels, count, tint);
+    } else if (blend == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        kernels->blendPremultiplied(dst, texels, count, tint);
+    } else if (source->mask) {
+        kernels->blendMask(dst, texels, count, tint);
+    } else {
+        kernels->blendTexture(dst, texels, count, tint);
+    }
+}
+
+// Pixels whose center lies in [from, to)
+INLINE int Framebuffer_firstPixel(float from) {
+    return (int)ceilf(from - 0.5f);
+}
+
+static void Framebuffer_drawRect(Framebuffer* self, const SDL_Rect* clip, const FramebufferSource* source, SDL_BlendMode blend,
+        const SDL_Vertex* topLeft, const SDL_Vertex* bottomRight, SDL_Color color) {
+    const float x0 = topLeft->position.x, y0 = topLeft->position.y;
+    const float x1 = bottomRight->position.x, y1 = bottomRight->position.y;
+    const int left = Framebuffer_firstPixel(x0), right = Framebuffer_firstPixel(x1);
+    int px0 = left, px1 = right;
+    int py0 = Framebuffer_firstPixel(y0), py1 = Framebuffer_firstPixel(y1);
+    if (px0 < clip->x) px0 = clip->x;
+    if (py0 < clip->y) py0 = clip->y;
+    if (px1 > clip->x + clip->w) px1 = clip->x + clip->w;
+    if (py1 > clip->y + clip->h) py1 = clip->y + clip->h;
+    if (px1 <= px0 || py1 <= py0) return;
+
+    if (!source) {
+        for (int y = py0; y < py1; y++) {
+            Framebuffer_colorSpan(Framebuffer_row(self->surface, y) + px0, px1 - px0, blend, color);
+        }
+        return;
+    }
+
+    const SDL_Surface* surface = source->surface;
+    const float u0 = topLeft->tex_coord.x, v0 = topLeft->tex_coord.y;
+    const float du = (bottomRight->tex_coord.x - u0) / (x1 - x0);
+    const float dv = (bottomRight->tex_coord.y - v0) / (y1 - y0);
+    // Decided on the whole rect so that drawing it in pieces (tiles) gives the same pixels
+    const int firstTexel = Framebuffer_texel(u0 + ((float)left + 0.5f - x0) * du, source->width, surface->w);
+    const int lastTexel = Framebuffer_texel(u0 + ((float)(right - 1) + 0.5f - x0) * du, source->width, surface->w);
+    // One texel per pixel, the common case of glyphs and unscaled images: spans read the texture rows directly
+    const bool direct = lastTexel - firstTexel == right - left - 1 && fabsf(du * (float)source->width - 1.0f) < 1e-4f;
+    Uint32 texels[FRAMEBUFFER_SPAN];
+    for (int y = py0; y < py1; y++) {
+        const int ty = Framebuffer_texel(v0 + ((float)y + 0.5f - y0) * dv, source->height, surface->h);
+        const Uint32* row = Framebuffer_row(surface, ty);
+        Uint32* dst = Framebuffer_row(self->surface, y);
+        if (direct) {
+            Framebuffer_texelSpan(dst + px0, row + firstTexel + (px0 - left), px1 - px0, source, blend, color);
+            continue;
+        }
+        for (int x = px0; x < px1; x += FRAMEBUFFER_SPAN) {
+            const int count = px1 - x < FRAMEBUFFER_SPAN ? px1 - x : FRAMEBUFFER_SPAN;
+            for (int i = 0; i < count; i++) {
+                texels[i] = row[Framebuffer_texel(u0 + ((float)(x + i) + 0.5f - x0) * du, source->width, surface->w)];
+            }
+            Framebuffer_texelSpan(dst + x, texels, count, source, blend, color);
+        }
+    }
+}
+
+INLINE float Framebuffer_edge(SDL_FPoint a, SDL_FPoint b, float x, float y) {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+// Pixels on an edge belong to one of the two triangles sharing it, whatever their order
+INLINE bool Framebuffer_ownsEdge(SDL_FPoint a, SDL_FPoint b) {
+    return b.y > a.y || (b.y == a.y && b.x < a.x);
+}
+
+INLINE bool Framebuffer_inside(float weight, bool owned) {
+    return weight > 0.0f || (weight == 0.0f && owned);
+}
+
+static SDL_FColor Framebuffer_lerpColor(const SDL_Vertex* a, const SDL_Vertex* b, const SDL_Vertex* c, float wa, float wb, float wc) {
+    return (SDL_FColor){
+        a->color.r * wa + b->color.r * wb + c->color.r * wc,
+        a->color.g * wa + b->color.g * wb + c->color.g * wc,
+        a->color.b * wa + b->color.b * wb + c->color.b * wc,
+        a->color.a * wa + b->color.a * wb + c->color.a * wc
+    };
+}
+
+static void Framebuffer_drawTriangle(Framebuffer* self, const SDL_Rect* clip, const FramebufferSource* source, SDL_BlendMode blend,
+        const SDL_Vertex* a, const SDL_Vertex* b, const SDL_Vertex* c) {
+    float area = Framebuffer_edge(a->position, b->position, c->position.x, c->position.y);
+    if (area == 0.0f) return;
+    if (area < 0.0f) {
+        const SDL_Vertex* swap = b;
+        b = c;
+        c = swap;
+        area = -area;
+    }
+    const SDL_FPoint pa = a->position, pb = b->position, pc = c->position;
+    const bool ownsA = Framebuffer_ownsEdge(pb, pc), ownsB = Framebuffer_ownsEdge(pc, pa), ownsC = Framebuffer_ownsEdge(pa, pb);
+    const float minX = fminf(pa.x, fminf(pb.x, pc.x)), maxX = fmaxf(pa.x, fmaxf(pb.x, pc.x));
+    const float minY = fminf(pa.y, fminf(pb.y, pc.y)), maxY = fmaxf(pa.y, fmaxf(pb.y, pc.y));
+    int px0 = Framebuffer_firstPixel(minX), px1 = Framebuffer_firstPixel(maxX) + 1;
+    int py0 = Framebuffer_firstPixel(minY), py1 = Framebuffer_firstPixel(maxY) + 1;
+    if (px0 < clip->x) px0 = clip->x;
+    if (py0 < clip->y) py0 = clip->y;
+    if (px1 > clip->x + clip->w) px1 = clip->x + clip->w;
+    if (py1 > clip->y + clip->h) py1 = clip->y + clip->h;
+    if (px1 <= px0 || py1 <= py0) return;
+
+    const bool flat = memcmp(&a->color, &b->color, sizeof(SDL_FColor)) == 0 && memcmp(&a->color, &c->color, sizeof(SDL_FColor)) == 0;
+    const SDL_Color flatColor = Framebuffer_color(a->color);
+    Uint32 texels[FRAMEBUFFER_SPAN];
+    for (int y = py0; y < py1; y++) {
+        Uint32* dst = Framebuffer_row(self->surface, y);
+        const float cy = (float)y + 0.5f;
+        int runStart = -1;
+        int runCount = 0;
+        for (int x = px0; x <= px1; x++) {
+            float wa = 0.0f, wb = 0.0f, wc = 0.0f;
+            bool inside = false;
+            if (x < px1) {
+                const float cx = (float)x + 0.5f;
+                wa = Framebuffer_edge(pb, pc, cx, cy);
+                wb = Framebuffer_edge(pc, pa, cx, cy);
+                wc = Framebuffer_edge(pa, pb, cx, cy);
+                inside = Framebuffer_inside(wa, ownsA) && Framebuffer_inside(wb, ownsB) && Framebuffer_inside(wc, ownsC);
+            }
+            if (inside && flat && (!source || runCount < FRAMEBUFFER_SPAN)) {
+                // Flat runs go through the kernels at once, texels gathered on the way
+                if (runStart < 0) runStart = x;
+                if (source) {
+                    const float u = (a->tex_coord.x * wa + b->tex_coord.x * wb + c->tex_coord.x * wc) / area;
+                    const float v = (a->tex_coord.y * wa + b->tex_coord.y * wb + c->tex_coord.y * wc) / area;
+                    texels[runCount] = Framebuffer_row(source->surface, Framebuffer_texel(v, source->height, source->surface->h))[Framebuffer_texel(u, source->width, source->surface->w)];
+                }
+                runCount++;
+                continue;
+            }
+            if (runCount > 0) {
+                if (source) {
+                    Framebuffer_texelSpan(dst + runStart, texels, runCount, source, blend, flatColor);
+                } else {
+                    Framebuffer_colorSpan(dst + runStart, runCount, blend, flatColor);
+                }
+                runStart = -1;
+                runCount = 0;
+                if (inside) {
+                    // The run was full, this pixel starts the next one
+                    x--;
+                }
+                continue;
+            }
+            if (!inside) continue;
+            const SDL_Color color = Framebuffer_color(Framebuffer_lerpColor(a, b, c, wa / area, wb / area, wc / area));
+            if (source) {
+                const float u = (a->tex_coord.x * wa + b->tex_coord.x * wb + c->tex_coord.x * wc) / area;
+                const float v = (a->tex_coord.y * wa + b->tex_coord.y * wb + c->tex_coord.y * wc) / area;
+                const Uint32 texel = Framebuffer_row(source->surface, Framebuffer_texel(v, source->height, source->surface->h))[Framebuffer_texel(u, source->width, source->surface->w)];
+                Framebuffer_texelSpan(dst + x, &texel, 1, source, blend, color);
+            } else {
+                Framebuffer_colorSpan(dst + x, 1, blend, color);
+            }
+        }
+    }
+}
+
+// Two triangles (a, b, c) and (a, c, d) forming an unrotated, unflipped rectangle with one color
+static bool Framebuffer_isRect(const SDL_Vertex* a, const SDL_Vertex* b, const SDL_Vertex* c, const SDL_Vertex* d) {
+    if (a->position.y != b->position.y || b->position.x != c->position.x ||
+        c->position.y != d->position.y || d->position.x != a->position.x) return false;
+    if (a->position.x >= b->position.x || a->position.y >= d->position.y) return false;
+    if (a->tex_coord.y != b->tex_coord.y || b->tex_coord.x != c->tex_coord.x ||
+        c->tex_coord.y != d->tex_coord.y || d->tex_coord.x != a->tex_coord.x) return false;
+    return memcmp(&a->color, &b->color, sizeof(SDL_FColor)) == 0 && memcmp(&a->color, &c->color, sizeof(SDL_FColor)) == 0 &&
+        memcmp(&a->color, &d->color, sizeof(SDL_FColor)) == 0;
+}
+
+static void Framebuffer_drawTriangles(Framebuffer* self, const SDL_Rect* area, const FramebufferSource* sampled, SDL_BlendMode blend,
+        const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+    for (int i = 0; i + 2 < indexCount;) {
+        const int* triangle = &indices[i];
+        if (triangle[0] < 0 || triangle[1] < 0 || triangle[2] < 0 ||
+            triangle[0] >= vertexCount || triangle[1] >= vertexCount || triangle[2] >= vertexCount) {
+            i += 3;
+            continue;
+        }
+        // Quads are recorded as (0, 1, 2, 0, 2, 3)
+        if (i + 5 < indexCount && triangle[3] == triangle[0] && triangle[4] == triangle[2] &&
+            triangle[5] >= 0 && triangle[5] < vertexCount) {
+            const SDL_Vertex* a = &vertices[triangle[0]];
+            const SDL_Vertex* c = &vertices[triangle[2]];
+            if (Framebuffer_isRect(a, &vertices[triangle[1]], c, &vertices[triangle[5]])) {
+                Framebuffer_drawRect(self, area, sampled, blend, a, c, Framebuffer_color(a->color));
+                i += 6;
+                continue;
+            }
+        }
+        Framebuffer_drawTriangle(self, area, sampled, blend, &vertices[triangle[0]], &vertices[triangle[1]], &vertices[triangle[2]]);
+        i += 3;
+    }
+}
+
+void Framebuffer_drawGeometry(Framebuffer* self, const SDL_Rect* clip, SDL_Texture* texture, SDL_BlendMode blend,
+        const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+    if (!self || !vertices || !indices) return;
+    FramebufferSource source;
+    if (texture && !Framebuffer_source(texture, &source)) return;
+    SDL_Rect area = { 0, 0, self->width, self->height };
+    if (clip && !SDL_GetRectIntersection(clip, &area, &area)) return;
+    Framebuffer_drawTriangles(self, &area, texture ? &source : NULL, blend, vertices, vertexCount, indices, indexCount);
+}
+
+// Pixels a draw may touch, empty when it draws nothing
+static SDL_Rect Framebuffer_drawBounds(const FramebufferDraw* draw) {
+    if (!draw->vertices || !draw->indices || draw->vertexCount <= 0 || draw->indexCount < 3) return (SDL_Rect){ 0 };
+    float minX = draw->vertices[0].position.x, maxX = minX;
+    float minY = draw->vertices[0].position.y, maxY = minY;
+    for (int i = 1; i < draw->vertexCount; i++) {
+        const SDL_FPoint p = draw->vertices[i].position;
+        minX = fminf(minX, p.x);
+        maxX = fmaxf(maxX, p.x);
+        minY = fminf(minY, p.y);
+        maxY = fmaxf(maxY, p.y);
+    }
+    // Same pixel range as the rasterizer, one extra pixel for triangles
+    const int x0 = Framebuffer_firstPixel(minX), x1 = Framebuffer_firstPixel(maxX) + 1;
+    const int y0 = Framebuffer_firstPixel(minY), y1 = Framebuffer_firstPixel(maxY) + 1;
+    return (SDL_Rect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+typedef struct {
+    Framebuffer* framebuffer;
+    const FramebufferDraw* draws;
+    SDL_Rect area;
+    int columns;
+} FramebufferTiles;
+
+static void Framebuffer_drawTile(void* data, int tile) {
+    const FramebufferTiles* tiles = data;
+    Framebuffer* self = tiles->framebuffer;
+    const int first = self->tileStarts.data[tile], last = self->tileStarts.data[tile + 1];
+    if (first == last) return;
+    SDL_Rect rect = {
+        tiles->area.x + (tile % tiles->columns) * FRAMEBUFFER_TILE,
+        tiles->area.y + (tile / tiles->columns) * FRAMEBUFFER_TILE,
+        FRAMEBUFFER_TILE, FRAMEBUFFER_TILE
+    };
+    if (!SDL_GetRectIntersection(&rect, &tiles->area, &rect)) return;
+    for (int i = first; i < last; i++) {
+        const int index = self->tileDraws.data[i];
+        const FramebufferDraw* draw = &tiles->draws[index];
+        const FramebufferSource* source = &self->sources.data[index];
+        Framebuffer_drawTriangles(self, &rect, source->surface ? source : NULL, draw->blend,
+            draw->vertices, draw->vertexCount, draw->indices, draw->indexCount);
+    }
+}
+
+void Framebuffer_drawList(Framebuffer* self, const SDL_Rect* clip, const FramebufferDraw* draws, int count, WorkerPool* workers) {
+    if (!self || !draws || count <= 0) return;
+    if (WorkerPool_size(workers) <= 1) {
+        for (int i = 0; i < count; i++) {
+            Framebuffer_drawGeometry(self, clip, draws[i].texture, draws[i].blend, draws[i].vertices, draws[i].vertexCount,
+                draws[i].indices, draws[i].indexCount);
+        }
+        return;
+    }
+    SDL_Rect area = { 0, 0, self->width, self->height };
+    if (clip && !SDL_GetRectIntersection(clip, &area, &area)) return;
+    const int columns = (area.w + FRAMEBUFFER_TILE - 1) / FRAMEBUFFER_TILE;
+    const int rows = (area.h + FRAMEBUFFER_TILE - 1) / FRAMEBUFFER_TILE;
+    const int tileCount = columns * rows;
+
+    // Texture properties are looked up once here rather than by every tile
+    Vec_FramebufferSource_clear(&self->sources);
+    Vec_SDLRect_clear(&self->drawBounds);
+    Vec_int_clear(&self->tileStarts);
+    if (!Vec_FramebufferSource_reserve(&self->sources, count) || !Vec_SDLRect_reserve(&self->drawBounds, count) ||
+        !Vec_int_reserve(&self->tileStarts, tileCount + 1)) return;
+    memset(self->tileStarts.data, 0, (tileCount + 1) * sizeof(int));
+    self->tileStarts.size = tileCount + 1;
+    int binned = 0;
+    for (int i = 0; i < count; i++) {
+        FramebufferSource source = { 0 };
+        SDL_Rect bounds = Framebuffer_drawBounds(&draws[i]);
+        if ((draws[i].texture && !Framebuffer_source(draws[i].texture, &source)) || !SDL_GetRectIntersection(&bounds, &area, &bounds)) {
+            bounds = (SDL_Rect){ 0 };
+        }
+        self->sources.data[i] = source;
+        self->drawBounds.data[i] = bounds;
+        if (bounds.w <= 0) continue;
+        const int c0 = (bounds.x - area.x) / FRAMEBUFFER_TILE, c1 = (bounds.x + bounds.w - 1 - area.x) / FRAMEBUFFER_TILE;
+        const int r0 = (bounds.y - area.y) / FRAMEBUFFER_TILE, r1 = (bounds.y + bounds.h - 1 - area.y) / FRAMEBUFFER_TILE;
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                self->tileStarts.data[r * columns + c + 1]++;
+            }
+        }
+        binned += (r1 - r0 + 1) * (c1 - c0 + 1);
+    }
+    self->sources.size = count;
+    self->drawBounds.size = count;
+
+    // Counts become offsets, then every tile receives its draws in submission order
+    for (int t = 0; t < tileCount; t++) {
+        self->tileStarts.data[t + 1] += self->tileStarts.data[t];
+    }
+    Vec_int_clear(&self->tileDraws);
+    if (!Vec_int_reserve(&self->tileDraws, binned > 0 ? binned : 1)) return;
+    self->tileDraws.size = binned;
+    for (int i = 0; i < count; i++) {
+        const SDL_Rect bounds = self->drawBounds.data[i];
+        if (bounds.w <= 0) continue;
+        const int c0 = (bounds.x - area.x) / FRAMEBUFFER_TILE, c1 = (bounds.x + bounds.w - 1 - area.x) / FRAMEBUFFER_TILE;
+        const int r0 = (bounds.y - area.y) / FRAMEBUFFER_TILE, r1 = (bounds.y + bounds.h - 1 - area.y) / FRAMEBUFFER_TILE;
+        for (int r = r0; r <= r1; r++) {
+            for (int c = c0; c <= c1; c++) {
+                self->tileDraws.data[self->tileStarts.data[r * columns + c]++] = i;
+            }
+        }
+    }
+    // Filling moved every start to the next one
+    for (int t = tileCount; t > 0; t--) {
+        self->tileStarts.data[t] = self->tileStarts.data[t - 1];
+    }
+    self->tileStarts.data[0] = 0;
+
+    // Workers must not race to pick the kernels
+    PixelKernels_get();
+    FramebufferTiles tiles = { self, draws, area, columns };
+    WorkerPool_run(workers, tileCount, Framebuffer_drawTile, &tiles);
+}
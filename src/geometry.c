@@ -4,9 +4,14 @@
  */
 #include "geometry.h"
 
+#include "arena.h"
 #include "logger.h"
+#include "render_queue.h"
 #include "utils.h"
 
+static Vec_int quadIndices;
+static Vec_SDLVertex shapeVertices;
+
 Box* Box_new(float width, float height, int border_size, Position* position, Color* background, Color* border_color, bool center) {
     Box* self = calloc(1, sizeof(Box));
     if (!self) {
@@ -23,8 +28,25 @@ Box* Box_new(float width, float height, int border_size, Position* position, Col
     return self;
 }
 
+Box* Box_newIn(Arena* arena, float width, float height, int border_size, Position* position, Color* background, Color* border_color, bool center) {
+    Box* self = Arena_alloc(arena, sizeof(Box));
+    if (!self) {
+        error("Box_newIn: Failed to allocate arena memory for Box");
+        return NULL;
+    }
+    self->size.width = width;
+    self->size.height = height;
+    self->border_size = border_size;
+    self->position = position;
+    self->background = background;
+    self->border_color = border_color;
+    self->center = center;
+    self->arena = arena;
+    return self;
+}
+
 void Box_destroy(Box* self) {
-    if (!self) return;
+    if (!self || self->arena) return;
     Position_destroy(self->position);
     Color_destroy(self->background);
     Color_destroy(self->border_color);
@@ -37,17 +59,14 @@ void Box_render(Box* self, SDL_Renderer* renderer) {
     SDL_FRect rect = self->center ? SDL_CreateRect(self->position->x, self->position->y, self->size.width, self->size.height) :
                 (SDL_FRect){ self->position->x, self->position->y, self->size.width, self->size.height };
 
+    RenderQueue* queue = RenderQueue_get(renderer);
     if (self->border_size > 0 && self->border_color) {
-        Color* border = self->border_color;
-        SDL_SetRenderDrawColor(renderer, border->r, border->g, border->b, border->a);
         SDL_FRect borderRect = {  rect.x - self->border_size, rect.y - self->border_size, rect.w + (self->border_size * 2), rect.h + (self->border_size * 2)};
-        SDL_RenderFillRect(renderer, &borderRect);
+        RenderQueue_fillRect(queue, &borderRect, self->border_color);
     }
 
     if (self->background) {
-        Color* background = self->background;
-        SDL_SetRenderDrawColor(renderer, background->r, background->g, background->b, background->a);
-        SDL_RenderFillRect(renderer, &rect);
+        RenderQueue_fillRect(queue, &rect, self->background);
     }
 }
 
@@ -73,31 +92,61 @@ void Circle_destroy(Circle* self) {
     safe_free((void**)&self);
 }
 
-static void Circle_draw(SDL_Renderer* renderer, float centerX, float centerY, int radius) {
-    for (int w = 0; w < radius * 2; w++) {
-        for (int h = 0; h < radius * 2; h++) {
-            int dx = radius - w;
-            int dy = radius - h;
-            if ((dx*dx + dy*dy) <= (radius * radius)) {
-                SDL_RenderPoint(renderer, centerX + dx, centerY + dy);
-            }
-        }
+static SDL_FColor Geometry_color(const Color* color) {
+    return (SDL_FColor){ color->r / 255.0f, color->g / 255.0f, color->b / 255.0f, color->a / 255.0f };
+}
+
+static void Geometry_pushQuad(Vec_SDLVertex* vertices, float x, float y, float w, float h, SDL_FColor color) {
+    Vec_SDLVertex_push(vertices, (SDL_Vertex){ { x, y }, color, { 0, 0 } });
+    Vec_SDLVertex_push(vertices, (SDL_Vertex){ { x + w, y }, color, { 0, 0 } });
+    Vec_SDLVertex_push(vertices, (SDL_Vertex){ { x + w, y + h }, color, { 0, 0 } });
+    Vec_SDLVertex_push(vertices, (SDL_Vertex){ { x, y + h }, color, { 0, 0 } });
+}
+
+// Largest half width of the row dy whose pixels are all inside the circle
+static int Circle_halfWidth(int radius, int dy) {
+    const int remaining = radius * radius - dy * dy;
+    int half = (int)sqrtf((float)remaining);
+    while (half * half > remaining) half--;
+    while ((half + 1) * (half + 1) <= remaining) half++;
+    return half;
+}
+
+// Appends one quad per run of consecutive rows sharing the same span
+static bool Circle_draw(Vec_SDLVertex* vertices, float centerX, float centerY, int radius, SDL_FColor color) {
+    if (radius <= 0) return true;
+    if (!Vec_SDLVertex_reserve(vertices, vertices->size + (size_t)(2 * radius + 1) * 4)) {
+        error("Circle_draw: Failed to allocate memory for vertices");
+        return false;
+    }
+    int rowStart = -radius;
+    int rowHalf = Circle_halfWidth(radius, rowStart);
+    for (int dy = -radius + 1; dy <= radius + 1; dy++) {
+        const int half = dy <= radius ? Circle_halfWidth(radius, dy) : -1;
+        if (half == rowHalf) continue;
+        Geometry_pushQuad(vertices, centerX - rowHalf, centerY + rowStart, rowHalf * 2 + 1, dy - rowStart, color);
+        rowStart = dy;
+        rowHalf = half;
     }
+    return true;
 }
 
 void Circle_render(Circle* self, SDL_Renderer *renderer) {
     if (!self || !renderer) return;
 
+    Vec_SDLVertex_clear(&shapeVertices);
     if (self->border_size > 0 && self->border_color) {
-        Color* border = self->border_color;
-        SDL_SetRenderDrawColor(renderer, border->r, border->g, border->b, border->a);
-        Circle_draw(renderer, self->center->x, self->center->y, self->radius + self->border_size);
+        if (!Circle_draw(&shapeVertices, self->center->x, self->center->y, self->radius + self->border_size, Geometry_color(self->border_color))) return;
     }
     if (self->background) {
-        Color* background = self->background;
-        SDL_SetRenderDrawColor(renderer, background->r, background->g, background->b, background->a);
-        Circle_draw(renderer, self->center->x, self->center->y, self->radius);
+        if (!Circle_draw(&shapeVertices, self->center->x, self->center->y, self->radius, Geometry_color(self->background))) return;
     }
+    if (shapeVertices.size == 0) return;
+
+    const int quadCount = (int)(shapeVertices.size / 4);
+    const int* indices = Geometry_quadIndices(quadCount);
+    if (!indices) return;
+    RenderQueue_geometry(RenderQueue_get(renderer), NULL, shapeVertices.data, (int)shapeVertices.size, indices, quadCount * 6);
 }
 
 Polygon* Polygon_new(Position** vertices, int vertex_count, int border_size, Color* background, Color* border) {
@@ -108,6 +157,7 @@ Polygon* Polygon_new(Position** vertices, int vertex_count, int border_size, Col
     }
     self->vertices = vertices;
     self->vertex_count = vertex_count;
+    self->capacity = vertex_count;
     self->border_size = border_size;
     self->background = background;
     self->border = border;
@@ -122,88 +172,196 @@ void Polygon_destroy(Polygon* self) {
     safe_free((void**)&self->vertices);
     Color_destroy(self->background);
     Color_destroy(self->border);
+    Vec_SDLVertex_destroy(&self->fill);
+    Vec_int_destroy(&self->fillIndices);
+    Vec_SDLVertex_destroy(&self->outline);
+    Vec_int_destroy(&self->outlineIndices);
+    safe_free((void**)&self->tessellated);
     safe_free((void**)&self);
 }
 
-typedef struct {
-    float x;
-} Intersection;
-
-static int compare_intersections(const void* a, const void* b) {
-    return ((Intersection*)a)->x - ((Intersection*)b)->x;
+static float Polygon_cross(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
 }
 
-void Polygon_render(Polygon* self, SDL_Renderer* renderer) {
-    if (!self || !renderer || self->vertex_count < 3) return;
+static bool Polygon_samePoint(SDL_FPoint a, SDL_FPoint b) {
+    return a.x == b.x && a.y == b.y;
+}
 
-    Color* background = self->background;
-    SDL_SetRenderDrawColor(renderer, background->r, background->g, background->b, background->a);
+// a, b and c must be in positive order
+static bool Polygon_inTriangle(SDL_FPoint p, SDL_FPoint a, SDL_FPoint b, SDL_FPoint c) {
+    return Polygon_cross(a, b, p) >= 0 && Polygon_cross(b, c, p) >= 0 && Polygon_cross(c, a, p) >= 0;
+}
 
-    float min_y = self->vertices[0]->y, max_y = self->vertices[0]->y;
-    float min_x = self->vertices[0]->x, max_x = self->vertices[0]->x;
+static bool Polygon_isEar(const SDL_FPoint* points, const int* remaining, int count, int prev, int current, int next) {
+    const SDL_FPoint a = points[prev];
+    const SDL_FPoint b = points[current];
+    const SDL_FPoint c = points[next];
+    if (Polygon_cross(a, b, c) <= 0) return false;
+    for (int k = 0; k < count; k++) {
+        const SDL_FPoint p = points[remaining[k]];
+        if (Polygon_samePoint(p, a) || Polygon_samePoint(p, b) || Polygon_samePoint(p, c)) continue;
+        if (Polygon_inTriangle(p, a, b, c)) return false;
+    }
+    return true;
+}
 
-    for (int i = 1; i < self->vertex_count; i++) {
-        if (self->vertices[i]->y < min_y) min_y = self->vertices[i]->y;
-        if (self->vertices[i]->y > max_y) max_y = self->vertices[i]->y;
-        if (self->vertices[i]->x < min_x) min_x = self->vertices[i]->x;
-        if (self->vertices[i]->x > max_x) max_x = self->vertices[i]->x;
+/*
+ * Ear clipping in O(n^2). When no ear is left (self-intersecting or degenerate outline)
+ * the current vertex is clipped anyway so the loop always ends.
+ */
+static bool Polygon_triangulate(Polygon* self, const SDL_FPoint* points, int count) {
+    Vec_int_clear(&self->fillIndices);
+    int* remaining = malloc(count * sizeof(int));
+    if (!remaining || !Vec_int_reserve(&self->fillIndices, (size_t)(count - 2) * 3)) {
+        error("Polygon_triangulate: Failed to allocate memory for triangulation");
+        safe_free((void**)&remaining);
+        return false;
     }
 
-    Intersection* intersections = calloc(self->vertex_count, sizeof(Intersection));
-    if (!intersections) {
-        error("Polygon_render: Failed to allocate memory for intersections");
-        return;
+    float area = 0.0f;
+    for (int i = 0, j = count - 1; i < count; j = i++) {
+        area += points[j].x * points[i].y - points[i].x * points[j].y;
+    }
+    // Walk the outline in positive order whatever the winding of the vertices
+    for (int i = 0; i < count; i++) {
+        remaining[i] = area >= 0 ? i : count - 1 - i;
     }
 
-    for (int y = min_y; y <= max_y; y++) {
-        int nb_intersections = 0;
+    int n = count;
+    int i = 0;
+    int misses = 0;
+    while (n > 3) {
+        const int prev = remaining[(i + n - 1) % n];
+        const int current = remaining[i];
+        const int next = remaining[(i + 1) % n];
+        if (misses < n && !Polygon_isEar(points, remaining, n, prev, current, next)) {
+            i = (i + 1) % n;
+            misses++;
+            continue;
+        }
+        Vec_int_push(&self->fillIndices, prev);
+        Vec_int_push(&self->fillIndices, current);
+        Vec_int_push(&self->fillIndices, next);
+        memmove(&remaining[i], &remaining[i + 1], (n - i - 1) * sizeof(int));
+        n--;
+        // The previous vertex may have become an ear
+        i = (i + n - 1) % n;
+        misses = 0;
+    }
+    Vec_int_push(&self->fillIndices, remaining[0]);
+    Vec_int_push(&self->fillIndices, remaining[1]);
+    Vec_int_push(&self->fillIndices, remaining[2]);
+    safe_free((void**)&remaining);
+    return true;
+}
 
-        for (int i = 0; i < self->vertex_count; i++) {
-            int j = (i + 1) % self->vertex_count;
+static SDL_FPoint Polygon_edgeNormal(SDL_FPoint from, SDL_FPoint to) {
+    const float dx = to.x - from.x;
+    const float dy = to.y - from.y;
+    const float len = sqrtf(dx * dx + dy * dy);
+    if (len == 0.0f) return (SDL_FPoint){ 0.0f, 0.0f };
+    return (SDL_FPoint){ -dy / len, dx / len };
+}
 
-            float y1 = self->vertices[i]->y;
-            float y2 = self->vertices[j]->y;
-            float x1 = self->vertices[i]->x;
-            float x2 = self->vertices[j]->x;
+// Closed strip of quads centered on the edges, two vertices per corner joined by a miter
+static bool Polygon_buildOutline(Polygon* self, const SDL_FPoint* points, int count) {
+    Vec_SDLVertex_clear(&self->outline);
+    Vec_int_clear(&self->outlineIndices);
+    if (self->border_size <= 0) return true;
+    if (!Vec_SDLVertex_reserve(&self->outline, (size_t)count * 2) || !Vec_int_reserve(&self->outlineIndices, (size_t)count * 6)) {
+        error("Polygon_buildOutline: Failed to allocate memory for the border");
+        return false;
+    }
 
-            if ((y1 <= y && y < y2) || (y2 <= y && y < y1)) {
-                int x = x1 + (y - y1) * (x2 - x1) / (y2 - y1);
-                intersections[nb_intersections].x = x;
-                nb_intersections++;
-            }
+    const float half = self->border_size / 2.0f;
+    for (int i = 0; i < count; i++) {
+        const SDL_FPoint prev = points[(i + count - 1) % count];
+        const SDL_FPoint current = points[i];
+        const SDL_FPoint next = points[(i + 1) % count];
+        SDL_FPoint before = Polygon_edgeNormal(prev, current);
+        SDL_FPoint after = Polygon_edgeNormal(current, next);
+        if (before.x == 0.0f && before.y == 0.0f) before = after;
+        if (after.x == 0.0f && after.y == 0.0f) after = before;
+
+        SDL_FPoint miter = { before.x + after.x, before.y + after.y };
+        const float len = sqrtf(miter.x * miter.x + miter.y * miter.y);
+        float offset = half;
+        if (len > 1e-4f) {
+            miter.x /= len;
+            miter.y /= len;
+            const float cosine = miter.x * after.x + miter.y * after.y;
+            offset = cosine > 1.0f / POLYGON_MITER_LIMIT ? half / cosine : half * POLYGON_MITER_LIMIT;
+        } else {
+            miter = after;
         }
+        Vec_SDLVertex_push(&self->outline, (SDL_Vertex){ .position = { current.x + miter.x * offset, current.y + miter.y * offset } });
+        Vec_SDLVertex_push(&self->outline, (SDL_Vertex){ .position = { current.x - miter.x * offset, current.y - miter.y * offset } });
+    }
+    for (int i = 0; i < count; i++) {
+        const int outer = i * 2;
+        const int nextOuter = ((i + 1) % count) * 2;
+        Vec_int_push(&self->outlineIndices, outer);
+        Vec_int_push(&self->outlineIndices, nextOuter);
+        Vec_int_push(&self->outlineIndices, nextOuter + 1);
+        Vec_int_push(&self->outlineIndices, outer);
+        Vec_int_push(&self->outlineIndices, nextOuter + 1);
+        Vec_int_push(&self->outlineIndices, outer + 1);
+    }
+    return true;
+}
 
-        qsort(intersections, nb_intersections, sizeof(Intersection), compare_intersections);
-
-        for (int i = 0; i < nb_intersections - 1; i += 2) {
-            SDL_RenderLine(renderer, intersections[i].x, y, intersections[i + 1].x, y);
+static bool Polygon_isTessellated(const Polygon* self) {
+    if (!self->tessellated || self->tessellatedCount != self->vertex_count || self->tessellatedBorder != self->border_size) {
+        return false;
+    }
+    for (int i = 0; i < self->vertex_count; i++) {
+        if (self->tessellated[i].x != self->vertices[i]->x || self->tessellated[i].y != self->vertices[i]->y) {
+            return false;
         }
     }
+    return true;
+}
 
-    if (self->border && self->border_size > 0) {
-        Color* border = self->border;
-        SDL_SetRenderDrawColor(renderer, border->r, border->g, border->b, border->a);
-        for (int i = 0; i < self->vertex_count; i++) {
-            int j = (i + 1) % self->vertex_count;
-            float x1 = self->vertices[i]->x;
-            float y1 = self->vertices[i]->y;
-            float x2 = self->vertices[j]->x;
-            float y2 = self->vertices[j]->y;
-
-            float dx = x2 - x1;
-            float dy = y2 - y1;
-            float len = sqrtf(dx * dx + dy * dy);
-            float nx = -dy / len;
-            float ny = dx / len;
-            for (int b = -self->border_size/2; b <= self->border_size/2; b++) {
-                float ox = nx * b;
-                float oy = ny * b;
-                SDL_RenderLine(renderer, x1 + ox, y1 + oy, x2 + ox, y2 + oy);
-            }
-        }
+static bool Polygon_tessellate(Polygon* self) {
+    const int count = self->vertex_count;
+    SDL_FPoint* points = realloc(self->tessellated, count * sizeof(SDL_FPoint));
+    if (!points || !Vec_SDLVertex_reserve(&self->fill, count)) {
+        error("Polygon_tessellate: Failed to allocate memory for the mesh");
+        if (points) self->tessellated = points;
+        self->tessellatedCount = 0;
+        return false;
+    }
+    self->tessellated = points;
+    Vec_SDLVertex_clear(&self->fill);
+    for (int i = 0; i < count; i++) {
+        points[i] = (SDL_FPoint){ self->vertices[i]->x, self->vertices[i]->y };
+        Vec_SDLVertex_push(&self->fill, (SDL_Vertex){ .position = points[i] });
+    }
+    if (!Polygon_triangulate(self, points, count) || !Polygon_buildOutline(self, points, count)) {
+        self->tessellatedCount = 0;
+        return false;
     }
+    self->tessellatedCount = count;
+    self->tessellatedBorder = self->border_size;
+    return true;
+}
+
+static void Polygon_drawMesh(SDL_Renderer* renderer, Vec_SDLVertex* vertices, const Vec_int* indices, const Color* color) {
+    if (!color || indices->size == 0) return;
+    const SDL_FColor vertexColor = Geometry_color(color);
+    for (size_t i = 0; i < vertices->size; i++) {
+        vertices->data[i].color = vertexColor;
+    }
+    RenderQueue_geometry(RenderQueue_get(renderer), NULL, vertices->data, (int)vertices->size, indices->data, (int)indices->size);
+}
 
-    safe_free((void**)&intersections);
+void Polygon_render(Polygon* self, SDL_Renderer* renderer) {
+    if (!self || !renderer || self->vertex_count < 3) return;
+
+    if (!Polygon_isTessellated(self) && !Polygon_tessellate(self)) return;
+    Polygon_drawMesh(renderer, &self->fill, &self->fillIndices, self->background);
+    Polygon_drawMesh(renderer, &self->outline, &self->outlineIndices, self->border);
 }
 
 Polygon* Polygon_newEmpty(int border_size, Color* background, Color* border) {
@@ -212,13 +370,14 @@ Polygon* Polygon_newEmpty(int border_size, Color* background, Color* border) {
         error("Polygon_newEmpty: Failed to allocate memory for Polygon");
         return NULL;
     }
-    self->vertices = calloc(1, sizeof(Position*));
+    self->vertices = calloc(POLYGON_MIN_CAPACITY, sizeof(Position*));
     if (!self->vertices) {
         error("Polygon_newEmpty: Failed to allocate memory for vertices");
         safe_free((void**)&self);
         return NULL;
     }
     self->vertex_count = 0;
+    self->capacity = POLYGON_MIN_CAPACITY;
     self->border_size = border_size;
     self->background = background;
     self->border = border;
@@ -226,11 +385,41 @@ Polygon* Polygon_newEmpty(int border_size, Color* background, Color* border) {
 }
 
 void Polygon_addVertex(Polygon* self, Position* vertex) {
+    if (self->vertex_count == self->capacity) {
+        const int capacity = self->capacity < POLYGON_MIN_CAPACITY ? POLYGON_MIN_CAPACITY : self->capacity * 2;
+        Position** new_vertices = realloc(self->vertices, capacity * sizeof(Position*));
+        if (!new_vertices) {
+            error("Polygon_addVertex: Failed to reallocate memory for vertices");
+            Position_destroy(vertex);
+            return;
+        }
+        self->vertices = new_vertices;
+        self->capacity = capacity;
+    }
     self->vertices[self->vertex_count++] = vertex;
-    Position** new_vertices = realloc(self->vertices, (self->vertex_count + 1) * sizeof(Position*));
-    if (!new_vertices) {
-        error("Polygon_addVertex: Failed to reallocate memory for vertices");
-        return;
+}
+
+const int* Geometry_quadIndices(int count) {
+    const size_t needed = (size_t)count * 6;
+    if (quadIndices.size >= needed) {
+        return quadIndices.data;
+    }
+    if (!Vec_int_reserve(&quadIndices, needed)) {
+        return NULL;
+    }
+    for (int quad = (int)(quadIndices.size / 6); quad < count; quad++) {
+        const int base = quad * 4;
+        Vec_int_push(&quadIndices, base);
+        Vec_int_push(&quadIndices, base + 1);
+        Vec_int_push(&quadIndices, base + 2);
+        Vec_int_push(&quadIndices, base);
+        Vec_int_push(&quadIndices, base + 2);
+        Vec_int_push(&quadIndices, base + 3);
     }
-    self->vertices = new_vertices;
+    return quadIndices.data;
+}
+
+void Geometry_releaseBuffers() {
+    Vec_int_destroy(&quadIndices);
+    Vec_SDLVertex_destroy(&shapeVertices);
 }
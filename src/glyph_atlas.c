@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "glyph_atlas.h"
+
+#include "framebuffer.h"
+#include "logger.h"
+#include "map.h"
+#include "render_queue.h"
+#include "utils.h"
+
+VEC_DEFINE_NAMED(Vec_GlyphAtlasPtr, GlyphAtlas*)
+
+static Vec_GlyphAtlasPtr atlases;
+static size_t rasterizedGlyphs;
+
+// The top-left 2x2 block stays opaque white for solid quads
+#define GLYPH_ATLAS_WHITE_SIZE 2
+
+static void GlyphAtlas_clearGlyphs(GlyphAtlas* atlas) {
+    Vec_Glyph_clear(&atlas->glyphs);
+    Map_clear(atlas->extended);
+    for (int i = 0; i < GLYPH_ATLAS_ASCII; i++) {
+        atlas->ascii[i] = -1;
+    }
+    SDL_FillSurfaceRect(atlas->surface, NULL, 0);
+    SDL_Rect white = { 0, 0, GLYPH_ATLAS_WHITE_SIZE, GLYPH_ATLAS_WHITE_SIZE };
+    SDL_FillSurfaceRect(atlas->surface, &white, SDL_MapSurfaceRGBA(atlas->surface, 255, 255, 255, 255));
+    atlas->shelfX = GLYPH_ATLAS_WHITE_SIZE + GLYPH_ATLAS_PADDING;
+    atlas->shelfY = 0;
+    atlas->shelfHeight = GLYPH_ATLAS_WHITE_SIZE;
+}
+
+static bool GlyphAtlas_upload(GlyphAtlas* atlas, const SDL_Rect* rect) {
+    const SDL_Surface* surface = atlas->surface;
+    const Uint8* pixels = surface->pixels;
+    if (rect) {
+        pixels += rect->y * surface->pitch + rect->x * 4;
+    }
+    if (!SDL_UpdateTexture(atlas->texture, rect, pixels, surface->pitch)) {
+        error("Failed to upload glyph atlas: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Replaces the surface and texture by new ones of the given size, keeping the pixels already packed.
+ * Text queued earlier in the frame still points at the old texture, the queue destroys it after drawing.
+ */
+static bool GlyphAtlas_resize(GlyphAtlas* atlas, int width, int height) {
+    SDL_Surface* surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        error("Failed to create glyph atlas surface: %s", SDL_GetError());
+        return false;
+    }
+    SDL_Texture* texture = SDL_CreateTexture(atlas->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        error("Failed to create glyph atlas texture: %s", SDL_GetError());
+        SDL_DestroySurface(surface);
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_FillSurfaceRect(surface, NULL, 0);
+    Framebuffer_attachSurface(texture, surface, true, false);
+
+    if (atlas->surface) {
+        SDL_SetSurfaceBlendMode(atlas->surface, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(atlas->surface, NULL, surface, NULL);
+        SDL_DestroySurface(atlas->surface);
+    }
+    if (atlas->texture) {
+        RenderQueue_retireTexture(RenderQueue_get(atlas->renderer), atlas->texture);
+    }
+    atlas->surface = surface;
+    atlas->texture = texture;
+    atlas->generation++;
+    return GlyphAtlas_upload(atlas, NULL);
+}
+
+static GlyphAtlas* GlyphAtlas_create(SDL_Renderer* renderer, TTF_Font* font, TTF_FontStyleFlags style) {
+    GlyphAtlas* atlas = calloc(1, sizeof(GlyphAtlas));
+    if (!atlas) {
+        error("Failed to allocate memory for GlyphAtlas");
+        return NULL;
+    }
+    atlas->renderer = renderer;
+    atlas->font = font;
+    atlas->style = style;
+    atlas->extended = Map_create(false);
+    atlas->lineHeight = TTF_GetFontHeight(font);
+    atlas->ascent = TTF_GetFontAscent(font);
+    if (!atlas->extended || !GlyphAtlas_resize(atlas, GLYPH_ATLAS_INITIAL_SIZE, GLYPH_ATLAS_INITIAL_SIZE)) {
+        Map_destroy(atlas->extended);
+        safe_free((void**)&atlas);
+        return NULL;
+    }
+    GlyphAtlas_clearGlyphs(atlas);
+    GlyphAtlas_upload(atlas, NULL);
+    return atlas;
+}
+
+static void GlyphAtlas_destroy(GlyphAtlas* atlas) {
+    if (!atlas) return;
+    if (atlas->texture) {
+        SDL_DestroyTexture(atlas->texture);
+    }
+    if (atlas->surface) {
+        SDL_DestroySurface(atlas->surface);
+    }
+    Vec_Glyph_destroy(&atlas->glyphs);
+    Map_destroy(atlas->extended);
+    safe_free((void**)&atlas);
+}
+
+GlyphAtlas* GlyphAtlas_get(SDL_Renderer* renderer, TTF_Font* font, TTF_FontStyleFlags style) {
+    if (!renderer || !font) return NULL;
+    style &= ~GLYPH_ATLAS_LINE_STYLES;
+    for (size_t i = 0; i < atlases.size; i++) {
+        GlyphAtlas* atlas = atlases.data[i];
+        if (atlas->renderer == renderer && atlas->font == font && atlas->style == style) {
+            return atlas;
+        }
+    }
+    GlyphAtlas* atlas = GlyphAtlas_create(renderer, font, style);
+    if (atlas && !Vec_GlyphAtlasPtr_push(&atlases, atlas)) {
+        GlyphAtlas_destroy(atlas);
+        return NULL;
+    }
+    return atlas;
+}
+
+// Shelf packing: glyphs fill rows left to right, a new row opens under the tallest glyph of the current one
+static bool GlyphAtlas_pack(GlyphAtlas* atlas, int width, int height, SDL_Rect* rect) {
+    if (width + GLYPH_ATLAS_PADDING > GLYPH_ATLAS_MAX_SIZE || height + GLYPH_ATLAS_PADDING > GLYPH_ATLAS_MAX_SIZE) {
+        return false;
+    }
+    while (true) {
+        const int atlasWidth = atlas->surface->w;
+        const int atlasHeight = atlas->surface->h;
+        if (width + GLYPH_ATLAS_PADDING <= atlasWidth) {
+            if (atlas->shelfX + width + GLYPH_ATLAS_PADDING > atlasWidth) {
+                atlas->shelfY += atlas->shelfHeight + GLYPH_ATLAS_PADDING;
+                atlas->shelfX = 0;
+                atlas->shelfHeight = 0;
+            }
+            if (atlas->shelfY + height + GLYPH_ATLAS_PADDING <= atlasHeight) {
+                *rect = (SDL_Rect){ atlas->shelfX, atlas->shelfY, width, height };
+                atlas->shelfX += width + GLYPH_ATLAS_PADDING;
+                if (height > atlas->shelfHeight) {
+                    atlas->shelfHeight = height;
+                }
+                return true;
+            }
+        }
+
+        if (atlasWidth < GLYPH_ATLAS_MAX_SIZE || atlasHeight < GLYPH_ATLAS_MAX_SIZE) {
+            // Packed pixels keep their place, only the free space grows
+            int newWidth = atlasWidth;
+            int newHeight = atlasHeight;
+            if ((width + GLYPH_ATLAS_PADDING > atlasWidth || atlasWidth < atlasHeight) && atlasWidth < GLYPH_ATLAS_MAX_SIZE) {
+                newWidth *= 2;
+            } else if (atlasHeight < GLYPH_ATLAS_MAX_SIZE) {
+                newHeight *= 2;
+            } else {
+                newWidth *= 2;
+            }
+            if (!GlyphAtlas_resize(atlas, newWidth, newHeight)) return false;
+        } else {
+            log_message(LOG_LEVEL_WARN, "Glyph atlas full, dropping %zu glyphs", atlas->glyphs.size);
+            // Cleared into a new texture, queued text keeps drawing the old glyphs
+            if (!GlyphAtlas_resize(atlas, atlasWidth, atlasHeight)) return false;
+            GlyphAtlas_clearGlyphs(atlas);
+            GlyphAtlas_upload(atlas, NULL);
+        }
+    }
+}
+
+static const Glyph* GlyphAtlas_rasterize(GlyphAtlas* atlas, Uint32 codepoint) {
+    TTF_SetFontStyle(atlas->font, atlas->style);
+    int minx, maxx, miny, maxy, advance;
+    if (!TTF_GetGlyphMetrics(atlas->font, codepoint, &minx, &maxx, &miny, &maxy, &advance)) {
+        return NULL;
+    }
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(atlas->font, codepoint, (SDL_Color){ 255, 255, 255, 255 });
+    if (!rendered) {
+        return NULL;
+    }
+
+    Glyph glyph = {
+        .codepoint = codepoint,
+        .offsetX = minx < 0 ? minx : 0,
+        .advance = advance
+    };
+    if (!GlyphAtlas_pack(atlas, rendered->w, rendered->h, &glyph.rect)) {
+        error("Glyph U+%04X does not fit in the glyph atlas", codepoint);
+        SDL_DestroySurface(rendered);
+        return NULL;
+    }
+    SDL_SetSurfaceBlendMode(rendered, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(rendered, NULL, atlas->surface, &glyph.rect);
+    SDL_DestroySurface(rendered);
+    GlyphAtlas_upload(atlas, &glyph.rect);
+    rasterizedGlyphs++;
+
+    if (!Vec_Glyph_push(&atlas->glyphs, glyph)) {
+        return NULL;
+    }
+    const int index = (int)atlas->glyphs.size - 1;
+    if (codepoint < GLYPH_ATLAS_ASCII) {
+        atlas->ascii[codepoint] = index;
+    } else {
+        Map_put(atlas->extended, (void*)(uintptr_t)codepoint, (void*)(intptr_t)(index + 1));
+    }
+    return &atlas->glyphs.data[index];
+}
+
+const Glyph* GlyphAtlas_glyph(GlyphAtlas* atlas, Uint32 codepoint) {
+    if (!atlas || codepoint == 0) return NULL;
+    if (codepoint < GLYPH_ATLAS_ASCII) {
+        if (atlas->ascii[codepoint] >= 0) {
+            return &atlas->glyphs.data[atlas->ascii[codepoint]];
+        }
+    } else {
+        intptr_t index = (intptr_t)Map_get(atlas->extended, (void*)(uintptr_t)codepoint);
+        if (index > 0) {
+            return &atlas->glyphs.data[index - 1];
+        }
+    }
+    return GlyphAtlas_rasterize(atlas, codepoint);
+}
+
+int GlyphAtlas_kerning(GlyphAtlas* atlas, Uint32 previous, Uint32 codepoint) {
+    if (!atlas || previous == 0) return 0;
+    int kerning = 0;
+    if (!TTF_GetGlyphKerning(atlas->font, previous, codepoint, &kerning)) {
+        return 0;
+    }
+    return kerning;
+}
+
+SDL_FPoint GlyphAtlas_whiteTexel(GlyphAtlas* atlas) {
+    const float half = GLYPH_ATLAS_WHITE_SIZE / 2.0f;
+    return (SDL_FPoint){ half / (float)atlas->surface->w, half / (float)atlas->surface->h };
+}
+
+size_t GlyphAtlas_rasterizedCount() {
+    return rasterizedGlyphs;
+}
+
+void GlyphAtlas_destroyAll() {
+    for (size_t i = 0; i < atlases.size; i++) {
+        GlyphAtlas_destroy(atlases.data[i]);
+    }
+    Vec_GlyphAtlasPtr_destroy(&atlases);
+}
@@ -5,12 +5,13 @@
 #include "image.h"
 
 #include "app.h"
+#include "image_atlas.h"
 #include "logger.h"
+#include "render_queue.h"
 #include "resource_manager.h"
+#include "scaled_image_cache.h"
 #include "utils.h"
 
-static SDL_Texture* Image_CreateScaledTexture(SDL_Texture* texture, SDL_Renderer* renderer, float new_width, float new_height);
-
 Image* Image_new(SDL_Texture* texture, Position* position, bool from_center) {
     Image* self = calloc(1, sizeof(Image));
     if (!self) {
@@ -21,6 +22,7 @@ Image* Image_new(SDL_Texture* texture, Position* position, bool from_center) {
     float w, h;
     SDL_GetTextureSize(texture, &w, &h);
     SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
+    self->source = (SDL_FRect){ 0, 0, w, h };
     self->size.width = w;
     self->size.height = h;
     self->position = position;
@@ -41,18 +43,17 @@ Image* Image_load(App* app, const char* path, Position* position, bool from_cent
     self->from_center = from_center;
     self->custom_size = false;
     self->ratio = 1.f;
-    SDL_Texture* texture = ResourceManager_getTexture(app->manager, path);
-    if (!texture) {
+    Sprite sprite;
+    if (!ResourceManager_getSprite(app->manager, path, &sprite)) {
         error("Failed to load texture from path: %s", path);
         safe_free((void**)&self);
         return NULL;
     }
-    self->texture = texture;
-    float w, h;
-    SDL_GetTextureSize(texture, &w, &h);
-    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
-    self->size.width = w;
-    self->size.height = h;
+    self->texture = sprite.texture;
+    self->source = sprite.source;
+    SDL_SetTextureScaleMode(sprite.texture, SDL_SCALEMODE_LINEAR);
+    self->size.width = sprite.source.w;
+    self->size.height = sprite.source.h;
     return self;
 }
 
@@ -85,15 +86,11 @@ void Image_render(Image* self, SDL_Renderer* renderer) {
         height *= self->ratio;
     }
 
+    // Much smaller than the image, a downscaled copy is drawn instead so fewer texels are sampled
+    const Sprite image = { self->texture, self->source };
+    const Sprite sprite = ScaledImageCache_find(ScaledImageCache_get(renderer), &image, width, height);
     SDL_FRect dst = { x, y, width, height };
-    if (!SDL_RenderTexture(renderer, self->texture, NULL, &dst)) {
-        error("Failed to render image texture : %s", SDL_GetError());
-    }
-    /*SDL_Texture* scaled = Image_CreateScaledTexture(self->texture, renderer, width, height);
-    SDL_FRect dst = { x, y, width, height };
-    if (!SDL_RenderTexture(renderer, scaled, NULL, &dst)) {
-        error("Failed to render image texture : %s", SDL_GetError());
-    }*/
+    RenderQueue_texture(RenderQueue_get(renderer), sprite.texture, &sprite.source, &dst);
 }
 
 void Image_setSize(Image* self, float width, float height) {
@@ -122,18 +119,3 @@ void Image_setRatio(Image* self, float ratio) {
     if (!self) return;
     self->ratio = ratio;
 }
-
-static SDL_Texture* Image_CreateScaledTexture(SDL_Texture* texture, SDL_Renderer* renderer, float new_width, float new_height) {
-    SDL_Texture* scaled = SDL_CreateTexture(renderer,
-        SDL_PIXELFORMAT_RGBA8888,
-        SDL_TEXTUREACCESS_TARGET,
-        new_width, new_height);
-
-    SDL_SetRenderTarget(renderer, scaled);
-
-    SDL_RenderTexture(renderer, texture, NULL, NULL);
-
-    SDL_SetRenderTarget(renderer, NULL);
-
-    return scaled;
-}
\ No newline at end of file
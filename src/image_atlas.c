@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "image_atlas.h"
+
+#include "framebuffer.h"
+#include "logger.h"
+#include "utils.h"
+
+void Skyline_init(Skyline* self, int width, int height) {
+    if (!self) return;
+    self->width = width;
+    self->height = height;
+    self->usedArea = 0;
+    Vec_SkylineNode_init(&self->nodes);
+    Vec_SkylineNode_push(&self->nodes, (SkylineNode){ 0, 0, width });
+}
+
+void Skyline_destroy(Skyline* self) {
+    if (!self) return;
+    Vec_SkylineNode_destroy(&self->nodes);
+}
+
+// Top of a rectangle resting on the skyline from node index, -1 when it goes past the edges
+static int Skyline_fit(const Skyline* self, size_t index, int width, int height) {
+    const SkylineNode* nodes = self->nodes.data;
+    if (nodes[index].x + width > self->width) return -1;
+    int y = 0;
+    int left = width;
+    for (size_t i = index; left > 0 && i < self->nodes.size; i++) {
+        if (nodes[i].y > y) y = nodes[i].y;
+        left -= nodes[i].width;
+    }
+    if (y + height > self->height) return -1;
+    return y;
+}
+
+bool Skyline_insert(Skyline* self, int width, int height, SDL_Point* position) {
+    if (!self || width <= 0 || height <= 0) return false;
+    int bestIndex = -1;
+    int bestBottom = 0;
+    int bestWidth = 0;
+    for (size_t i = 0; i < self->nodes.size; i++) {
+        const int y = Skyline_fit(self, i, width, height);
+        if (y < 0) continue;
+        const int bottom = y + height;
+        if (bestIndex < 0 || bottom < bestBottom || (bottom == bestBottom && self->nodes.data[i].width < bestWidth)) {
+            bestIndex = (int)i;
+            bestBottom = bottom;
+            bestWidth = self->nodes.data[i].width;
+        }
+    }
+    if (bestIndex < 0) return false;
+
+    const SkylineNode node = { self->nodes.data[bestIndex].x, bestBottom, width };
+    if (!Vec_SkylineNode_push(&self->nodes, node)) return false;
+    SkylineNode* nodes = self->nodes.data;
+    memmove(&nodes[bestIndex + 1], &nodes[bestIndex], (self->nodes.size - bestIndex - 1) * sizeof(SkylineNode));
+    nodes[bestIndex] = node;
+
+    // The nodes the new one covers shrink or disappear
+    for (size_t i = bestIndex + 1; i < self->nodes.size;) {
+        const int end = nodes[i - 1].x + nodes[i - 1].width;
+        if (nodes[i].x >= end) break;
+        const int shrink = end - nodes[i].x;
+        nodes[i].x += shrink;
+        nodes[i].width -= shrink;
+        if (nodes[i].width > 0) break;
+        Vec_SkylineNode_remove(&self->nodes, i);
+    }
+    for (size_t i = 0; i + 1 < self->nodes.size;) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].width += nodes[i + 1].width;
+            Vec_SkylineNode_remove(&self->nodes, i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    self->usedArea += (size_t)width * height;
+    position->x = node.x;
+    position->y = bestBottom - height;
+    return true;
+}
+
+size_t Skyline_wastedArea(const Skyline* self) {
+    if (!self) return 0;
+    size_t covered = 0;
+    for (size_t i = 0; i < self->nodes.size; i++) {
+        covered += (size_t)self->nodes.data[i].y * self->nodes.data[i].width;
+    }
+    return covered - self->usedArea;
+}
+
+static ImageAtlasPage* ImageAtlasPage_create(SDL_Renderer* renderer) {
+    ImageAtlasPage* page = calloc(1, sizeof(ImageAtlasPage));
+    if (!page) {
+        error("Failed to allocate memory for ImageAtlasPage");
+        return NULL;
+    }
+    page->surface = SDL_CreateSurface(IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE, SDL_PIXELFORMAT_RGBA32);
+    page->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE);
+    if (!page->surface || !page->texture) {
+        error("Failed to create image atlas page: %s", SDL_GetError());
+        if (page->surface) SDL_DestroySurface(page->surface);
+        if (page->texture) SDL_DestroyTexture(page->texture);
+        safe_free((void**)&page);
+        return NULL;
+    }
+    SDL_FillSurfaceRect(page->surface, NULL, 0);
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(page->texture, SDL_SCALEMODE_LINEAR);
+    Framebuffer_attachSurface(page->texture, page->surface, false, false);
+    Skyline_init(&page->skyline, IMAGE_ATLAS_PAGE_SIZE, IMAGE_ATLAS_PAGE_SIZE);
+    return page;
+}
+
+static void ImageAtlasPage_destroy(ImageAtlasPage* page) {
+    if (!page) return;
+    Skyline_destroy(&page->skyline);
+    SDL_DestroySurface(page->surface);
+    SDL_DestroyTexture(page->texture);
+    safe_free((void**)&page);
+}
+
+ImageAtlas* ImageAtlas_create(SDL_Renderer* renderer) {
+    ImageAtlas* self = calloc(1, sizeof(ImageAtlas));
+    if (!self) {
+        error("Failed to allocate memory for ImageAtlas");
+        return NULL;
+    }
+    self->renderer = renderer;
+    return self;
+}
+
+void ImageAtlas_destroy(ImageAtlas* self) {
+    if (!self) return;
+    for (size_t i = 0; i < self->pages.size; i++) {
+        ImageAtlasPage_destroy(self->pages.data[i]);
+    }
+    Vec_ImageAtlasPagePtr_destroy(&self->pages);
+    safe_free((void**)&self);
+}
+
+// Copies image at (x, y) of the page, then repeats its outermost pixels in the extrusion border around it
+static void ImageAtlasPage_blit(ImageAtlasPage* page, SDL_Surface* image, int x, int y) {
+    const int e = IMAGE_ATLAS_EXTRUDE;
+    const int w = image->w;
+    const int h = image->h;
+    SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+    SDL_Rect dst = { x + e, y + e, w, h };
+    SDL_BlitSurface(image, NULL, page->surface, &dst);
+    for (int i = 0; i < e; i++) {
+        const SDL_Rect top = { 0, 0, w, 1 }, bottom = { 0, h - 1, w, 1 };
+        const SDL_Rect left = { 0, 0, 1, h }, right = { w - 1, 0, 1, h };
+        SDL_BlitSurface(image, &top, page->surface, &(SDL_Rect){ x + e, y + i, w, 1 });
+        SDL_BlitSurface(image, &bottom, page->surface, &(SDL_Rect){ x + e, y + e + h + i, w, 1 });
+        SDL_BlitSurface(image, &left, page->surface, &(SDL_Rect){ x + i, y + e, 1, h });
+        SDL_BlitSurface(image, &right, page->surface, &(SDL_Rect){ x + e + w + i, y + e, 1, h });
+    }
+    // The corners take the color of the corner pixels
+    const SDL_Rect corners[4] = { { 0, 0, 1, 1 }, { w - 1, 0, 1, 1 }, { 0, h - 1, 1, 1 }, { w - 1, h - 1, 1, 1 } };
+    const SDL_Point origins[4] = { { x, y }, { x + e + w, y }, { x, y + e + h }, { x + e + w, y + e + h } };
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < e * e; i++) {
+            SDL_Rect corner = { origins[c].x + i % e, origins[c].y + i / e, 1, 1 };
+            SDL_BlitSurface(image, &corners[c], page->surface, &corner);
+        }
+    }
+}
+
+bool ImageAtlas_add(ImageAtlas* self, SDL_Surface* image, Sprite* sprite) {
+    if (!self || !image || !sprite) return false;
+    if (image->w > IMAGE_ATLAS_MAX_IMAGE || image->h > IMAGE_ATLAS_MAX_IMAGE) return false;
+    const int slotWidth = image->w + IMAGE_ATLAS_EXTRUDE * 2;
+    const int slotHeight = image->h + IMAGE_ATLAS_EXTRUDE * 2;
+
+    ImageAtlasPage* page = NULL;
+    SDL_Point position;
+    for (size_t i = 0; i < self->pages.size && !page; i++) {
+        if (Skyline_insert(&self->pages.data[i]->skyline, slotWidth, slotHeight, &position)) {
+            page = self->pages.data[i];
+        }
+    }
+    if (!page) {
+        page = ImageAtlasPage_create(self->renderer);
+        if (!page) return false;
+        if (!Vec_ImageAtlasPagePtr_push(&self->pages, page)) {
+            ImageAtlasPage_destroy(page);
+            return false;
+        }
+        if (!Skyline_insert(&page->skyline, slotWidth, slotHeight, &position)) return false;
+    }
+
+    ImageAtlasPage_blit(page, image, position.x, position.y);
+    const SDL_Rect slot = { position.x, position.y, slotWidth, slotHeight };
+    const Uint8* pixels = (const Uint8*)page->surface->pixels + slot.y * page->surface->pitch + slot.x * 4;
+    if (!SDL_UpdateTexture(page->texture, &slot, pixels, page->surface->pitch)) {
+        error("Failed to upload image atlas page: %s", SDL_GetError());
+        return false;
+    }
+    page->images++;
+    self->images++;
+    sprite->texture = page->texture;
+    sprite->source = (SDL_FRect){ (float)(position.x + IMAGE_ATLAS_EXTRUDE), (float)(position.y + IMAGE_ATLAS_EXTRUDE), (float)image->w, (float)image->h };
+    return true;
+}
+
+void ImageAtlas_logStats(ImageAtlas* self) {
+    if (!self) return;
+    const double pageArea = (double)IMAGE_ATLAS_PAGE_SIZE * IMAGE_ATLAS_PAGE_SIZE;
+    log_message(LOG_LEVEL_DEBUG, "Image atlas: %zu images on %zu pages", self->images, self->pages.size);
+    for (size_t i = 0; i < self->pages.size; i++) {
+        const ImageAtlasPage* page = self->pages.data[i];
+        log_message(LOG_LEVEL_DEBUG, "Image atlas page %zu: %d images, %.1f%% occupied, %.1f%% wasted",
+            i, page->images, 100.0 * (double)page->skyline.usedArea / pageArea,
+            100.0 * (double)Skyline_wastedArea(&page->skyline) / pageArea);
+    }
+}
@@ -36,6 +36,7 @@ Input *Input_create() {
         safe_free((void **) &input);
         return NULL;
     }
+    NodePool_init(&input->handlerPool, sizeof(EventHandler));
     float x, y;
     SDL_GetMouseState(&x, &y);
     input->mousePos = Position_new(x, y);
@@ -43,50 +44,131 @@ Input *Input_create() {
     return input;
 }
 
+// Handler lists are kept once created, even when empty, so refocusing an element only recycles pool blocks
+static List *Input_getHandlers(Map *map, void *key) {
+    List *handlers = Map_get(map, key);
+    if (!handlers) {
+        handlers = List_create();
+        if (!handlers) {
+            error("Failed to create handlers list");
+            return NULL;
+        }
+        Map_put(map, key, handlers);
+    }
+    return handlers;
+}
+
+static void Input_freeHandlers(Input *input, List *handlers) {
+    if (!handlers) return;
+    LIST_FOREACH(node, handlers) {
+        NodePool_free(&input->handlerPool, node->value);
+    }
+    List_destroy(handlers);
+}
+
+static void Input_clearHandlerMap(Input *input, Map *map) {
+    if (!map) return;
+    MAP_FOREACH(node, map) {
+        Input_freeHandlers(input, node->value);
+    }
+    Map_clear(map);
+}
+
+/*
+ * Callbacks run while a handler list is walked can remove any handler, including ones the walk has not
+ * reached yet. Removals made during a dispatch only clear the handler, it is unlinked once the dispatch ends.
+ */
+static void Input_releaseHandler(Input *input, List *handlers, ListNode *node) {
+    EventHandler *handler = node->value;
+    if (input->dispatching > 0) {
+        handler->func = NULL;
+        handler->data = NULL;
+        input->handlersRemoved = true;
+        return;
+    }
+    List_removeNode(handlers, node);
+    NodePool_free(&input->handlerPool, handler);
+}
+
+static void Input_releaseHandlers(Input *input, List *handlers) {
+    if (!handlers) return;
+    LIST_FOREACH(node, handlers) {
+        Input_releaseHandler(input, handlers, node);
+    }
+}
+
+static void Input_sweepHandlerMap(Input *input, Map *map) {
+    MAP_FOREACH(entry, map) {
+        List *handlers = entry->value;
+        LIST_FOREACH(node, handlers) {
+            EventHandler *handler = node->value;
+            if (!handler->func) {
+                List_removeNode(handlers, node);
+                NodePool_free(&input->handlerPool, handler);
+            }
+        }
+    }
+}
+
+static void Input_dispatch(Input *input, List *handlers, SDL_Event *evt) {
+    if (!handlers) return;
+    input->dispatching++;
+    LIST_FOREACH(node, handlers) {
+        const EventHandler *handler = node->value;
+        if (handler->func) {
+            handler->func(input, evt, handler->data);
+        }
+    }
+    input->dispatching--;
+    if (input->dispatching == 0 && input->handlersRemoved) {
+        input->handlersRemoved = false;
+        Input_sweepHandlerMap(input, input->eventHandlers);
+        Input_sweepHandlerMap(input, input->keyEventHandlers);
+    }
+}
+
+static void Input_removeOneHandler(Input *input, Map *map, void *key, void *data) {
+    List *handlers = Map_get(map, key);
+    if (!handlers) return;
+
+    LIST_FOREACH(node, handlers) {
+        EventHandler *handler = node->value;
+        if (handler->func && handler->data == data) {
+            Input_releaseHandler(input, handlers, node);
+            break;
+        }
+    }
+}
+
+static void Input_addHandler(Input *input, Map *map, void *key, EventHandlerFunc func, void *data) {
+    List *handlers = Input_getHandlers(map, key);
+    if (!handlers) return;
+    EventHandler *handler = NodePool_alloc(&input->handlerPool);
+    if (!handler) {
+        error("Failed to allocate memory for EventHandler");
+        return;
+    }
+    handler->func = func;
+    handler->data = data;
+    List_push(handlers, (void *) handler);
+}
+
 void Input_destroy(Input *input) {
     if (!input) return;
 
     List_destroy(input->keysDown);
 
     if (input->eventHandlers) {
-        MapIterator *it = MapIterator_new(input->eventHandlers);
-        while (MapIterator_hasNext(it)) {
-            MapIterator_next(it);
-            List *handlers = (List *) MapIterator_value(it);
-            if (handlers) {
-                // Destroy all EventHandlers in the list
-                ListIterator *lit = ListIterator_new(handlers);
-                while (ListIterator_hasNext(lit)) {
-                    EventHandler *handler = ListIterator_next(lit);
-                    safe_free((void **) &handler);
-                }
-                ListIterator_destroy(lit);
-                List_destroy(handlers);
-            }
-        }
-        MapIterator_destroy(it);
+        Input_clearHandlerMap(input, input->eventHandlers);
         Map_destroy(input->eventHandlers);
     }
 
     if (input->keyEventHandlers) {
-        MapIterator *it = MapIterator_new(input->keyEventHandlers);
-        while (MapIterator_hasNext(it)) {
-            MapIterator_next(it);
-            List *handlers = (List *) MapIterator_value(it);
-            if (handlers) {
-                ListIterator *lit = ListIterator_new(handlers);
-                while (ListIterator_hasNext(lit)) {
-                    EventHandler *handler = ListIterator_next(lit);
-                    safe_free((void **) &handler);
-                }
-                ListIterator_destroy(lit);
-                List_destroy(handlers);
-            }
-        }
-        MapIterator_destroy(it);
+        Input_clearHandlerMap(input, input->keyEventHandlers);
         Map_destroy(input->keyEventHandlers);
     }
 
+    NodePool_release(&input->handlerPool);
     Position_destroy(input->mousePos);
     safe_free((void **) &input);
 }
@@ -95,32 +177,16 @@ void Input_update(Input *input) {
     SDL_Event evt;
     SDL_Scancode code;
     while (SDL_PollEvent(&evt)) {
-        if (input->eventHandlers && Map_containsKey(input->eventHandlers, (void *) evt.type)) {
-            List *handlers = Map_get(input->eventHandlers, (void *) evt.type);
-            ListIterator *it = ListIterator_new(handlers);
-            while (ListIterator_hasNext(it)) {
-                const EventHandler *handler = ListIterator_next(it);
-                if (handler) {
-                    handler->func(input, &evt, handler->data);
-                }
-            }
-            ListIterator_destroy(it);
+        if (input->eventHandlers) {
+            Input_dispatch(input, Map_get(input->eventHandlers, (void *) evt.type), &evt);
         }
         switch (evt.type) {
             case SDL_EVENT_QUIT:
                 input->quit = true;
                 break;
             case SDL_EVENT_KEY_DOWN:
-                if (input->keyEventHandlers && Map_containsKey(input->keyEventHandlers, (void *) evt.key.key)) {
-                    List *handlers = Map_get(input->keyEventHandlers, (void *) evt.key.key);
-                    ListIterator *it = ListIterator_new(handlers);
-                    while (ListIterator_hasNext(it)) {
-                        const EventHandler *handler = ListIterator_next(it);
-                        if (handler) {
-                            handler->func(input, &evt, handler->data);
-                        }
-                    }
-                    ListIterator_destroy(it);
+                if (input->keyEventHandlers) {
+                    Input_dispatch(input, Map_get(input->keyEventHandlers, (void *) evt.key.key), &evt);
                 }
                 code = evt.key.key;
                 input->lastPressed = code;
@@ -188,114 +254,44 @@ bool Input_mouseInRect(Input *input, SDL_FRect rect) {
 
 void Input_addKeyEventHandler(Input *input, SDL_Scancode key, EventHandlerFunc func, void *data) {
     if (!input || !func) return;
-    EventHandler *handler = calloc(1, sizeof(EventHandler));
-    if (!handler) {
-        error("Failed to allocate memory for EventHandler");
-        return;
-    }
-    handler->func = func;
-    handler->data = data;
-    if (!Map_containsKey(input->keyEventHandlers, (void *) key)) {
-        List *handlers = List_create();
-        List_push(handlers, (void *) handler);
-        Map_put(input->keyEventHandlers, (void *) key, handlers);
-    } else {
-        List *handlers = Map_get(input->keyEventHandlers, (void *) key);
-        List_push(handlers, (void *) handler);
-    }
-}
-
-static void Input_destroyEventHandler(void* value) {
-    EventHandler* handler = value;
-    safe_free((void**)&handler);
+    Input_addHandler(input, input->keyEventHandlers, (void *) key, func, data);
 }
 
 void Input_removeKeyEventHandler(Input *input, SDL_Scancode key) {
     if (!input) return;
-    List_destroyWitValues(Map_get(input->keyEventHandlers, (void*)key), Input_destroyEventHandler);
-    Map_remove(input->keyEventHandlers, (void *) key);
+    Input_releaseHandlers(input, Map_get(input->keyEventHandlers, (void *) key));
 }
 
 void Input_removeOneKeyEventHandler(Input *input, SDL_Scancode key, void *data) {
     if (!input || !data) return;
-
-    if (!Map_containsKey(input->keyEventHandlers, (void *) key)) {
-        return;
-    }
-
-    List *handlers = Map_get(input->keyEventHandlers, (void *) key);
-    ListIterator *it = ListIterator_new(handlers);
-    while (ListIterator_hasNext(it)) {
-        EventHandler *handler = ListIterator_next(it);
-        if (handler && handler->data == data) {
-            List_remove(handlers, (void *) handler);
-            safe_free((void**)&handler);
-            break;
-        }
-    }
-    ListIterator_destroy(it);
-    if (List_size(handlers) == 0) {
-        Map_remove(input->keyEventHandlers, (void *) key);
-        List_destroy(handlers);
-    }
+    Input_removeOneHandler(input, input->keyEventHandlers, (void *) key, data);
 }
 
 void Input_clearKeyEventHandlers(Input *input) {
     if (!input) return;
-    Map_clear(input->keyEventHandlers);
+    MAP_FOREACH(node, input->keyEventHandlers) {
+        Input_releaseHandlers(input, node->value);
+    }
 }
 
 void Input_addEventHandler(Input *input, Uint32 eventType, EventHandlerFunc func, void *data) {
     if (!input || !func) return;
-    EventHandler *handler = calloc(1, sizeof(EventHandler));
-    if (!handler) {
-        error("Failed to allocate memory for EventHandler");
-        return;
-    }
-    handler->func = func;
-    handler->data = data;
-    if (!Map_containsKey(input->eventHandlers, (void *) eventType)) {
-        List *handlers = List_create();
-        List_push(handlers, (void *) handler);
-        Map_put(input->eventHandlers, (void *) eventType, handlers);
-    } else {
-        List *handlers = Map_get(input->eventHandlers, (void *) eventType);
-        List_push(handlers, (void *) handler);
-    }
+    Input_addHandler(input, input->eventHandlers, (void *) eventType, func, data);
 }
 
 void Input_removeEventHandler(Input *input, Uint32 eventType) {
     if (!input) return;
-    List_destroyWitValues(Map_get(input->eventHandlers, (void*)eventType), Input_destroyEventHandler);
-    Map_remove(input->eventHandlers, (void *) eventType);
+    Input_releaseHandlers(input, Map_get(input->eventHandlers, (void *) eventType));
 }
 
 void Input_removeOneEventHandler(Input *input, Uint32 eventType, void *data) {
     if (!input || !data) return;
-
-    if (!Map_containsKey(input->eventHandlers, (void *) eventType)) {
-        return;
-    }
-
-    List *handlers = Map_get(input->eventHandlers, (void *) eventType);
-    ListIterator *it = ListIterator_new(handlers);
-    while (ListIterator_hasNext(it)) {
-        EventHandler *handler = ListIterator_next(it);
-        if (handler && handler->data == data) {
-            List_remove(handlers, (void *) handler);
-            safe_free((void**)&handler);
-            break;
-        }
-    }
-    ListIterator_destroy(it);
-    if (List_size(handlers) == 0) {
-        Map_remove(input->eventHandlers, (void *) eventType);
-        List_destroy(handlers);
-    }
+    Input_removeOneHandler(input, input->eventHandlers, (void *) eventType, data);
 }
 
-
 void Input_clearEventHandlers(Input *input) {
     if (!input) return;
-    Map_clear(input->eventHandlers);
+    MAP_FOREACH(node, input->eventHandlers) {
+        Input_releaseHandlers(input, node->value);
+    }
 }
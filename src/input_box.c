@@ -7,10 +7,12 @@
 #include "app.h"
 #include "input.h"
 #include "logger.h"
+#include "string_builder.h"
 #include "style.h"
 #include "text.h"
 #include "timer.h"
 #include "utils.h"
+#include "widget_skin.h"
 
 static void InputBox_checkKeyDown(Input* input, SDL_Event* event, void* data);
 static void InputBox_checkMouseClick(Input* input, SDL_Event* event, void* data);
@@ -23,6 +25,8 @@ InputBox *InputBox_new(App *app, SDL_FRect rect, InputBoxStyle *style, void* par
     }
     self->rect = rect;
     self->style = style;
+    self->styleVersion = style->version;
+    self->colorsVersion = style->colors->version;
     self->app = app;
     self->str = Strdup("");
     self->input = app->input;
@@ -48,19 +52,28 @@ void InputBox_destroy(InputBox *self) {
     safe_free((void **) &self);
 }
 
+static void InputBox_syncStyle(InputBox *self) {
+    InputBoxStyle *style = self->style;
+    if (style->version != self->styleVersion) {
+        self->styleVersion = style->version;
+        Text_setFont(self->text, style->font, style->text_size, style->style);
+    }
+    if (style->colors->version != self->colorsVersion) {
+        self->colorsVersion = style->colors->version;
+        Text_setColor(self->text, Color_copy(style->colors->text));
+    }
+}
+
 void InputBox_render(InputBox *self, SDL_Renderer *renderer) {
 
-    Text_setColor(self->text, Color_copy(self->style->colors->text));
+    InputBox_syncStyle(self);
 
     Color *border = self->style->colors->border;
     Color *fill = self->style->colors->background;
-    SDL_SetRenderDrawColor(renderer, border->r, border->g, border->b, border->a);
-
-    SDL_FRect borderRect = {self->rect.x - 2, self->rect.y - 2, self->rect.w + 4, self->rect.h + 4};
-    SDL_RenderFillRect(renderer, &borderRect);
+    const int borderWidth = self->style->border_width;
 
-    SDL_SetRenderDrawColor(renderer, fill->r, fill->g, fill->b, fill->a);
-    SDL_RenderFillRect(renderer, &self->rect);
+    SDL_FRect borderRect = {self->rect.x - borderWidth, self->rect.y - borderWidth, self->rect.w + borderWidth * 2, self->rect.h + borderWidth * 2};
+    WidgetSkin_draw(renderer, &borderRect, fill, border, borderWidth, self->style->corner_radius, &self->style->shadow);
 
     const float textX = self->rect.x + 5;
     const float textY = self->rect.y + (self->rect.h / 2) - (Text_getSize(self->text).height / 2);
@@ -132,13 +145,16 @@ char* InputBox_getFormattedString(InputBox* self) {
 
 void InputBox_setStringf(InputBox *self, const char *format, ...) {
     if (!format || !self) return;
+    StringBuilder* sb = StringBuilder_acquire();
+    if (!sb) return;
     va_list args;
     va_start(args, format);
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    StringBuilder_appendv(sb, format, args);
     va_end(args);
-    self->str = Strdup(buffer);
-    Text_setString(self->text, buffer);
+    safe_free((void**)&self->str);
+    self->str = StringBuilder_build(sb);
+    Text_setString(self->text, StringBuilder_view(sb));
+    StringBuilder_release(sb);
 }
 
 char* InputBox_getString(InputBox* input_box) {
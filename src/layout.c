@@ -8,7 +8,6 @@
 #include "element.h"
 #include "geometry.h"
 #include "input_box.h"
-#include "list.h"
 #include "logger.h"
 #include "style.h"
 #include "text.h"
@@ -140,12 +139,7 @@ FlexContainer *FlexContainer_new(const float x, const float y, const float width
         return NULL;
     }
 
-    container->items = List_create();
-    if (!container->items) {
-        error("FlexContainer_new: Failed to create items list");
-        safe_free((void **) &container);
-        return NULL;
-    }
+    Vec_FlexItem_init(&container->items);
 
     container->direction = FLEX_DIRECTION_ROW;
     container->justify_content = FLEX_JUSTIFY_START;
@@ -162,16 +156,7 @@ FlexContainer *FlexContainer_new(const float x, const float y, const float width
 void FlexContainer_destroy(FlexContainer *container) {
     if (!container) return;
 
-    if (container->items) {
-        ListIterator *it = ListIterator_new(container->items);
-        while (ListIterator_hasNext(it)) {
-            FlexItem *item = ListIterator_next(it);
-            safe_free((void **) &item);
-        }
-        ListIterator_destroy(it);
-        List_destroy(container->items);
-    }
-
+    Vec_FlexItem_destroy(&container->items);
     safe_free((void **) &container);
 }
 
@@ -199,34 +184,29 @@ void FlexContainer_addElement(FlexContainer *container, Element *element, float
                               float flex_basis) {
     if (!container || !element) return;
 
-    FlexItem *item = calloc(1, sizeof(FlexItem));
-    if (!item) {
-        error("FlexContainer_addElement: Failed to allocate memory for FlexItem");
-        return;
-    }
+    FlexItem item = { 0 };
+    item.element = element;
+    item.flex_grow = flex_grow;
+    item.flex_shrink = flex_shrink;
+    item.flex_basis = flex_basis;
 
-    item->element = element;
-    item->flex_grow = flex_grow;
-    item->flex_shrink = flex_shrink;
-    item->flex_basis = flex_basis;
-
-    FlexItem_getElementSize(item, &item->width, &item->height);
+    FlexItem_getElementSize(&item, &item.width, &item.height);
 
     if (flex_basis >= 0) {
         if (container->direction == FLEX_DIRECTION_ROW || container->direction == FLEX_DIRECTION_ROW_REVERSE) {
-            item->width = flex_basis;
+            item.width = flex_basis;
         } else {
-            item->height = flex_basis;
+            item.height = flex_basis;
         }
     }
 
-    List_push(container->items, item);
+    Vec_FlexItem_push(&container->items, item);
 }
 
 void FlexContainer_layout(FlexContainer *container) {
-    if (!container || !container->items) return;
+    if (!container) return;
 
-    int item_count = List_size(container->items);
+    int item_count = (int) container->items.size;
     if (item_count == 0) return;
 
     bool is_row = container->direction == FLEX_DIRECTION_ROW || container->direction == FLEX_DIRECTION_ROW_REVERSE;
@@ -238,9 +218,9 @@ void FlexContainer_layout(FlexContainer *container) {
     float total_flex_shrink = 0;
     float total_gap = container->gap * (item_count - 1);
 
-    ListIterator *it = ListIterator_new(container->items);
-    while (ListIterator_hasNext(it)) {
-        FlexItem *item = ListIterator_next(it);
+    FlexItem *items = container->items.data;
+    for (int i = 0; i < item_count; i++) {
+        FlexItem *item = &items[i];
         total_main_size += is_row ? item->width : item->height;
         if (item->element->type == ELEMENT_TYPE_BUTTON) {
             Button *btn = item->element->data.button;
@@ -251,14 +231,12 @@ void FlexContainer_layout(FlexContainer *container) {
         total_flex_grow += item->flex_grow;
         total_flex_shrink += item->flex_shrink;
     }
-    ListIterator_destroy(it);
 
     float available_space = (is_row ? container->width : container->height) - total_main_size - total_gap;
 
     if (available_space > 0 && total_flex_grow > 0) {
-        it = ListIterator_new(container->items);
-        while (ListIterator_hasNext(it)) {
-            FlexItem *item = ListIterator_next(it);
+        for (int i = 0; i < item_count; i++) {
+            FlexItem *item = &items[i];
             if (item->flex_grow > 0) {
                 float extra = (available_space * item->flex_grow) / total_flex_grow;
                 if (is_row) {
@@ -268,13 +246,11 @@ void FlexContainer_layout(FlexContainer *container) {
                 }
             }
         }
-        ListIterator_destroy(it);
         available_space = 0;
     } else if (available_space < 0 && total_flex_shrink > 0) {
         float shrink_amount = -available_space;
-        it = ListIterator_new(container->items);
-        while (ListIterator_hasNext(it)) {
-            FlexItem *item = ListIterator_next(it);
+        for (int i = 0; i < item_count; i++) {
+            FlexItem *item = &items[i];
             if (item->flex_shrink > 0) {
                 float reduction = (shrink_amount * item->flex_shrink) / total_flex_shrink;
                 if (is_row) {
@@ -284,7 +260,6 @@ void FlexContainer_layout(FlexContainer *container) {
                 }
             }
         }
-        ListIterator_destroy(it);
         available_space = 0;
     }
 
@@ -317,9 +292,8 @@ void FlexContainer_layout(FlexContainer *container) {
 
     float current_main = main_start;
 
-    it = ListIterator_new(container->items);
-    while (ListIterator_hasNext(it)) {
-        FlexItem *item = ListIterator_next(it);
+    for (int i = 0; i < item_count; i++) {
+        FlexItem *item = &items[i];
 
         float cross_pos = 0;
         switch (container->align_items) {
@@ -379,5 +353,4 @@ void FlexContainer_layout(FlexContainer *container) {
         }
         current_main += main_size + container->gap + item_spacing;
     }
-    ListIterator_destroy(it);
 }
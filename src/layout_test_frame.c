@@ -152,6 +152,9 @@ static void LayoutTestFrame_addElements(LayoutTestFrame* self) {
         //EdgeInsets_zero()
         EdgeInsets_newSymmetric(8, 15)
         ), self, "Button");
+    btn2->style->corner_radius = 8;
+    btn2->style->shadow = (WidgetShadow){ 0, 3, 6, { 0, 0, 0, 90 } };
+    ButtonStyle_touch(btn2->style);
     Element* elt4 = Element_fromButton(btn2, NULL);
     FlexContainer_addElement(self->columnContainer, elt4, 1.f, 1.f, -1.f);
     List_push(self->elements, elt4);
@@ -161,6 +164,8 @@ static void LayoutTestFrame_addElements(LayoutTestFrame* self) {
         TTF_STYLE_NORMAL,
         FullStyleColors_new(COLOR_WHITE, COLOR_GRAY(100), COLOR_BLACK)
         ), self);
+    input2->style->corner_radius = 6;
+    InputBoxStyle_touch(input2->style);
     Element* elt5 = Element_fromInput(input2, NULL);
     FlexContainer_addElement(self->columnContainer, elt5, 1.f, 0.f, -1.f);
     List_push(self->elements, elt5);
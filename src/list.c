@@ -4,6 +4,7 @@
  */
 #include "list.h"
 #include "logger.h"
+#include "sort.h"
 #include "utils.h"
 #include "string_builder.h"
 
@@ -17,7 +18,8 @@ List *List_create() {
         error("Failed to allocate memory for List");
         return NULL;
     }
-    list->head = calloc(1, sizeof(ListNode));
+    NodePool_init(&list->pool, sizeof(ListNode));
+    list->head = NodePool_alloc(&list->pool);
     if (!list->head) {
         error("Failed to allocate memory for ListNode");
         safe_free((void **) &list);
@@ -31,8 +33,8 @@ List *List_create() {
 
 void List_destroy(List *list) {
     if (!list) return;
-    List_clear(list);
-    safe_free((void **) &list->head);
+    // Nodes and head all live in the pool chunks, release them in bulk
+    NodePool_release(&list->pool);
     safe_free((void **) &list);
 }
 
@@ -51,8 +53,7 @@ void List_clear(List *list) {
     ListNode *node = list->head->next;
     while (node != list->head) {
         ListNode *next = node->next;
-        if (node == list->head && next == list->head) break;
-        safe_free((void **) &node);
+        NodePool_free(&list->pool, node);
         node = next;
     }
     list->size = 0;
@@ -61,7 +62,7 @@ void List_clear(List *list) {
 }
 
 void List_push(List *list, void *value) {
-    ListNode *node = calloc(1, sizeof(ListNode));
+    ListNode *node = NodePool_alloc(&list->pool);
     if (!node) {
         error("Failed to allocate memory for ListNode");
         return;
@@ -83,7 +84,7 @@ void List_remove(List *list, void *value) {
             ListNode *next = node->next;
             prev->next = next;
             next->prev = prev;
-            safe_free((void **) &node);
+            NodePool_free(&list->pool, node);
             list->size--;
             return;
         }
@@ -91,6 +92,14 @@ void List_remove(List *list, void *value) {
     }
 }
 
+void List_removeNode(List *list, ListNode *node) {
+    if (!node || node == list->head) return;
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    NodePool_free(&list->pool, node);
+    list->size--;
+}
+
 void *List_pop(List *list, size_t index) {
     if (index >= list->size || list->size == 0) {
         error("Index out of bounds");
@@ -105,7 +114,7 @@ void *List_pop(List *list, size_t index) {
     ListNode *next = node->next;
     prev->next = next;
     next->prev = prev;
-    safe_free((void **) &node);
+    NodePool_free(&list->pool, node);
     list->size--;
     return value;
 }
@@ -118,6 +127,10 @@ bool List_empty(List *list) {
     return list->size == 0;
 }
 
+NodePoolStats List_poolStats(List *list) {
+    return NodePool_getStats(&list->pool);
+}
+
 bool List_contains(List *list, void *value, bool isString) {
     ListNode *node = list->head->next;
     while (node != list->head) {
@@ -176,7 +189,7 @@ void List_set(List *list, size_t index, void *value) {
 }
 
 char *List_toString(List *list, const char *format, void * (*formatValueFunc)(void *value)) {
-    StringBuilder *sb = StringBuilder_create(DEFAULT_CAPACITY);
+    StringBuilder *sb = StringBuilder_acquire();
     if (!sb) return NULL;
     StringBuilder_append(sb, "[");
     ListNode *node = list->head->next;
@@ -199,7 +212,7 @@ char *List_toString(List *list, const char *format, void * (*formatValueFunc)(vo
     }
     StringBuilder_append(sb, "]");
     char *result = StringBuilder_build(sb);
-    StringBuilder_destroy(sb);
+    StringBuilder_release(sb);
     return result;
 }
 
@@ -373,6 +386,67 @@ static void List_sortMerge(List* list) {
     new_last->next = list->head;
 }
 
+static void** List_toArray(List* list) {
+    void** items = malloc(list->size * sizeof(void*));
+    if (!items) {
+        error("Failed to allocate memory for List sort buffer");
+        return NULL;
+    }
+    size_t i = 0;
+    LIST_FOREACH(node, list) {
+        items[i++] = node->value;
+    }
+    return items;
+}
+
+static void List_fromArray(List* list, void** items) {
+    size_t i = 0;
+    LIST_FOREACH(node, list) {
+        node->value = items[i++];
+    }
+}
+
+static int List_compareInt(const void* a, const void* b, void* ctx) {
+    (void)ctx;
+    intptr_t x = (intptr_t)a;
+    intptr_t y = (intptr_t)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t List_keyInt(const void* value, void* ctx) {
+    (void)ctx;
+    return (int64_t)(intptr_t)value;
+}
+
+void List_sortBy(List* list, CompareFunc cmp, void* ctx) {
+    if (!list || list->size < 2 || !cmp) return;
+    void** items = List_toArray(list);
+    if (!items) return;
+    if (Sort_tim(items, list->size, cmp, ctx)) {
+        List_fromArray(list, items);
+    }
+    safe_free((void**)&items);
+}
+
+void List_sortUnstableBy(List* list, CompareFunc cmp, void* ctx) {
+    if (!list || list->size < 2 || !cmp) return;
+    void** items = List_toArray(list);
+    if (!items) return;
+    Sort_intro(items, list->size, cmp, ctx);
+    List_fromArray(list, items);
+    safe_free((void**)&items);
+}
+
+void List_sortByKey(List* list, SortKeyFunc key, void* ctx) {
+    if (!list || list->size < 2 || !key) return;
+    void** items = List_toArray(list);
+    if (!items) return;
+    if (Sort_radix(items, list->size, key, ctx)) {
+        List_fromArray(list, items);
+    }
+    safe_free((void**)&items);
+}
+
 void List_sort(List* list, ListSortType sortType) {
     switch (sortType) {
         case LIST_SORT_TYPE_BUBBLE:
@@ -384,22 +458,37 @@ void List_sort(List* list, ListSortType sortType) {
         case LIST_SORT_TYPE_MERGE:
             List_sortMerge(list);
             break;
+        case LIST_SORT_TYPE_INTRO:
+            List_sortUnstableBy(list, List_compareInt, NULL);
+            break;
+        case LIST_SORT_TYPE_TIM:
+            List_sortBy(list, List_compareInt, NULL);
+            break;
+        case LIST_SORT_TYPE_RADIX:
+            List_sortByKey(list, List_keyInt, NULL);
+            break;
         default:
             log_message(LOG_LEVEL_WARN, "Unknown ListSortType: %d", sortType);
             break;
     }
 }
 
+ListIterator ListIterator_of(List *list) {
+    return (ListIterator) {
+        .head = list->head,
+        .current = list->head->next,
+        .index = 0,
+        .size = list->size
+    };
+}
+
 ListIterator *ListIterator_new(List *list) {
     ListIterator *iterator = calloc(1, sizeof(ListIterator));
     if (!iterator) {
         error("Failed to allocate memory for ListIterator");
         return NULL;
     }
-    iterator->head = list->head;
-    iterator->current = list->head->next;
-    iterator->index = 0;
-    iterator->size = list->size;
+    *iterator = ListIterator_of(list);
     return iterator;
 }
 
@@ -4,20 +4,120 @@
  */
 #include "Settings.h"
 #include "app.h"
+#include "arena.h"
+#include "atom.h"
+#include "canvas.h"
 #include "frame.h"
+#include "geometry.h"
+#include "glyph_atlas.h"
 #include "logger.h"
 #include "utils.h"
 #include "input.h"
+#include "layout_test_frame.h"
 #include "list.h"
 #include "main_frame.h"
+#include "pool.h"
+#include "render_queue.h"
 #include "resource_manager.h"
+#include "second_frame.h"
 #include "style.h"
+#include "text_cache.h"
+#include "text_measure.h"
+#include "timer.h"
+#include "vec.h"
+
+#define HEADLESS_DEFAULT_FRAMES 120
+
+/*
+ * Command line of the app. A headless run uses the offscreen video driver and the software renderer,
+ * runs a fixed number of frames on a simulated clock without waiting between them and can dump
+ * chosen frames to PNG files, so full frames can be timed and compared on machines without display.
+ */
+typedef struct {
+    bool headless;
+    // Frames rasterized by the pixel kernels into a framebuffer uploaded once per frame
+    bool software;
+    // Threads rasterizing software frames by tiles, 0 for every logical core
+    int threads;
+    int frames;
+    const char* frame;
+    const char* captureDir;
+    Vec_int captures;
+} RunOptions;
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--headless] [--software] [--threads <n>] [--frames <n>] [--frame main|second|layout] [--capture <frame>]... [--capture-dir <dir>]\n", program);
+}
+
+static bool parseOptions(int argc, char** argv, RunOptions* options) {
+    options->frames = HEADLESS_DEFAULT_FRAMES;
+    options->threads = 1;
+    options->frame = "main";
+    options->captureDir = ".";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options->headless = true;
+        } else if (strcmp(argv[i], "--software") == 0) {
+            options->software = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options->threads = String_parseInt(argv[++i], 1);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            options->frames = String_parseInt(argv[++i], HEADLESS_DEFAULT_FRAMES);
+            // Cast to size_t by the frame loop, a negative count would never end a headless run
+            if (options->frames < 0) return false;
+        } else if (strcmp(argv[i], "--frame") == 0 && i + 1 < argc) {
+            options->frame = argv[++i];
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            const int capture = String_parseInt(argv[++i], -1);
+            if (capture < 0 || !Vec_int_push(&options->captures, capture)) return false;
+        } else if (strcmp(argv[i], "--capture-dir") == 0 && i + 1 < argc) {
+            options->captureDir = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return strcmp(options->frame, "main") == 0 || strcmp(options->frame, "second") == 0 || strcmp(options->frame, "layout") == 0;
+}
+
+static bool isCaptured(const RunOptions* options, int frame) {
+    for (size_t i = 0; i < options->captures.size; i++) {
+        if (options->captures.data[i] == frame) return true;
+    }
+    return false;
+}
+
+static void captureFrame(App* app, const RunOptions* options, const Frame* frame, int index) {
+    SDL_Surface* surface = Canvas_capture(app->canvas);
+    if (!surface) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s_%04d.png", options->captureDir, frame->title ? frame->title : "frame", index);
+    if (!IMG_SavePNG(surface, path)) {
+        error("Failed to save frame capture %s : %s", path, SDL_GetError());
+    } else {
+        log_message(LOG_LEVEL_INFO, "Captured frame %d to %s", index, path);
+    }
+    SDL_DestroySurface(surface);
+}
 
 #if 1
-int main() {
+int main(int argc, char** argv) {
+    RunOptions options = { 0 };
+    if (!parseOptions(argc, argv, &options)) {
+        printUsage(argv[0]);
+        Vec_int_destroy(&options.captures);
+        return EXIT_FAILURE;
+    }
+
     log_message(LOG_LEVEL_INFO, "Starting up app %s", APP_NAME);
     log_message(LOG_LEVEL_DEBUG, "Debug mode is enabled");
 
+    if (options.headless) {
+        // Must be set before SDL_Init picks the drivers
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+        Timer_useFixedClock(0);
+    }
+
     int exitStatus = init();
 
     if (exitStatus == EXIT_FAILURE) {
@@ -27,7 +127,9 @@ int main() {
     SDL_WindowFlags flags = SDL_WINDOW_RESIZABLE;
 
 #if !defined(FULLSCREEN) || (defined(FULLSCREEN) && FULLSCREEN == 1)
-    flags |= SDL_WINDOW_FULLSCREEN;
+    if (!options.headless) {
+        flags |= SDL_WINDOW_FULLSCREEN;
+    }
 #endif
 
     SDL_Window* window = SDL_CreateWindow(WINDOW_TITLE,
@@ -39,7 +141,7 @@ int main() {
         exit(EXIT_FAILURE);
     }
 
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, NULL);
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, options.headless ? SDL_SOFTWARE_RENDERER : NULL);
     if (!renderer) {
         error("Unable to create renderer: %s", SDL_GetError());
         SDL_Quit();
@@ -69,12 +171,30 @@ int main() {
     }
 
     app->theme = Theme_default(app->manager);
+    if (options.software) {
+        Canvas_setSoftware(app->canvas, true);
+        Canvas_setThreads(app->canvas, options.threads);
+    }
 
     App_addFrame(app, MainFrame_getFrame(MainFrame_new(app)));
+    if (strcmp(options.frame, "second") == 0) {
+        App_addFrame(app, SecondFrame_getFrame(SecondFrame_new(app)));
+    } else if (strcmp(options.frame, "layout") == 0) {
+        App_addFrame(app, LayoutTestFrame_getFrame(LayoutTestFrame_new(app)));
+    }
 
     Uint64 frame_delay = 1000 / FRAME_RATE;
+    // A steady frame neither rasterizes glyphs nor lays text out
+    size_t frames = 0;
+    size_t textFrames = 0;
+    const Uint64 run_start = SDL_GetTicksNS();
+    // Simulated milliseconds of the frames run so far, whole steps averaging 1000 / FRAME_RATE
+    Uint64 simulated = 0;
 
     while (app->running) {
+        if (options.headless && frames >= (size_t)options.frames) {
+            break;
+        }
         Uint64 frame_start = SDL_GetTicks();
 
         Input_update(app->input);
@@ -84,16 +204,14 @@ int main() {
             break;
         }
 
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-
-        Color* background = app->theme->background;
-        SDL_SetRenderDrawColor(renderer, background->r, background->g, background->b, background->a);
-        SDL_RenderClear(renderer);
-
         Frame* frame = App_getCurrentFrame(app);
+        const size_t rasterized = GlyphAtlas_rasterizedCount();
+        const size_t layouts = TextRun_layoutCount();
 
         if (!frame) {
             log_message(LOG_LEVEL_WARN, "No current frame to render.");
+            // Without frames a headless run would never reach its frame count
+            if (options.headless) break;
             continue;
         }
 
@@ -103,19 +221,43 @@ int main() {
             app->frameChanged = false;
             if (!frame) {
                 log_message(LOG_LEVEL_WARN, "No current frame to render after frame change.");
+                if (options.headless) break;
                 continue;
             }
         }
         Frame_render(frame, renderer);
+        // Skips drawing and presenting entirely when the frame looks the same as the previous one
+        Canvas_present(app->canvas, RenderQueue_get(renderer), app->theme->background);
+        Arena_reset(app->frameArena);
+        // Only now that no frame-arena Text borrows a run anymore
+        TextCache_trim(app->manager->textCache);
+        if (isCaptured(&options, (int)frames)) {
+            captureFrame(app, &options, frame, (int)frames);
+        }
+        frames++;
+        if (GlyphAtlas_rasterizedCount() != rasterized || TextRun_layoutCount() != layouts) {
+            textFrames++;
+        }
 
-        SDL_RenderPresent(app->renderer);
-
+        if (options.headless) {
+            // Simulated time runs at the target frame rate whatever the frame cost, without drifting
+            const Uint64 target = (Uint64)frames * 1000 / FRAME_RATE;
+            Timer_advanceClock(target - simulated);
+            simulated = target;
+            continue;
+        }
         Uint64 frame_time = SDL_GetTicks() - frame_start;
         if (frame_delay > frame_time) {
             SDL_Delay(frame_delay - frame_time);
         }
     }
 
+    if (options.headless && frames > 0) {
+        const double elapsed = (double)(SDL_GetTicksNS() - run_start) / 1e6;
+        log_message(LOG_LEVEL_INFO, "Headless run: %zu frames of %s in %.2f ms, %.3f ms per frame",
+            frames, options.frame, elapsed, elapsed / (double)frames);
+    }
+
     while (List_size(app->stack) > 0) {
         Frame* frame = List_popLast(app->stack);
         Frame_destroy(frame);
@@ -123,11 +265,23 @@ int main() {
 
     SDL_CloseAudioDevice(audioDevice);
 
+    log_message(LOG_LEVEL_DEBUG, "Text: %zu glyphs rasterized, %zu layouts, %zu of %zu frames did text work",
+        GlyphAtlas_rasterizedCount(), TextRun_layoutCount(), textFrames, frames);
     // Need to be destroyed before App_quit because it uses SDL3 functions
+    Canvas_logStats(app->canvas);
+    Canvas_destroy(app->canvas);
+    GlyphAtlas_destroyAll();
+    TextMeasure_logStats();
+    TextMeasure_destroyAll();
+    RenderQueue_destroyAll();
+    Geometry_releaseBuffers();
     ResourceManager_destroy(app->manager);
 
     App_quit(app);
     App_destroy(app);
+    NodePool_logGlobalStats();
+    Atom_shutdown();
+    Vec_int_destroy(&options.captures);
     log_message(LOG_LEVEL_INFO, "App has been closed.");
     return EXIT_SUCCESS;
 }
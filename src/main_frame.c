@@ -46,12 +46,9 @@ MainFrame* MainFrame_new(App* app) {
 }
 
 static void MainFrame_addElements(MainFrame* self, App* app) {
-    ListIterator* it = ListIterator_new(self->elements);
-    while (ListIterator_hasNext(it)) {
-        Element* element = ListIterator_next(it);
-        Element_destroy(element);
+    LIST_FOREACH(node, self->elements) {
+        Element_destroy(node->value);
     }
-    ListIterator_destroy(it);
     List_clear(self->elements);
     int w, h;
     SDL_GetWindowSize(app->window, &w, &h);
@@ -9,13 +9,114 @@
 #include "utils.h"
 #include "string_builder.h"
 
+static uint32_t Map_hashString(const char* str) {
+    if (!str) return 0;
+    uint32_t hash = 2166136261u;
+    while (*str) {
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t Map_hashPointer(const void* ptr) {
+    uint64_t x = (uint64_t)(uintptr_t)ptr;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return (uint32_t)x;
+}
+
+static uint32_t Map_hash(const Map* map, const void* key) {
+    return map->is_key_string ? Map_hashString(key) : Map_hashPointer(key);
+}
+
+static bool Map_keyEquals(const Map* map, const void* a, const void* b) {
+    return map->is_key_string ? String_equals(a, b) : a == b;
+}
+
+static void Map_indexInsert(Map* map, MapNode* node) {
+    const size_t mask = map->capacity - 1;
+    MapBucket entry = { node, node->hash, 1 };
+    size_t i = entry.hash & mask;
+    while (map->buckets[i].distance != 0) {
+        MapBucket* bucket = &map->buckets[i];
+        if (bucket->distance < entry.distance) {
+            MapBucket tmp = *bucket;
+            *bucket = entry;
+            entry = tmp;
+        }
+        entry.distance++;
+        i = (i + 1) & mask;
+    }
+    map->buckets[i] = entry;
+}
+
+static bool Map_findSlot(const Map* map, const void* key, uint32_t hash, size_t* slot) {
+    if (map->capacity == 0) return false;
+    const size_t mask = map->capacity - 1;
+    size_t i = hash & mask;
+    for (uint32_t distance = 1; ; distance++) {
+        const MapBucket* bucket = &map->buckets[i];
+        // An empty slot or a richer entry means the key would have been placed before this point
+        if (bucket->distance < distance) {
+            return false;
+        }
+        if (bucket->hash == hash && Map_keyEquals(map, bucket->node->key, key)) {
+            *slot = i;
+            return true;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+static void Map_indexRemove(Map* map, size_t slot) {
+    const size_t mask = map->capacity - 1;
+    size_t next = (slot + 1) & mask;
+    while (map->buckets[next].distance > 1) {
+        map->buckets[slot] = map->buckets[next];
+        map->buckets[slot].distance--;
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    map->buckets[slot] = (MapBucket){ 0 };
+}
+
+static bool Map_rehash(Map* map, size_t capacity) {
+    MapBucket* buckets = calloc(capacity, sizeof(MapBucket));
+    if (!buckets) {
+        error("Failed to allocate memory for Map buckets");
+        return false;
+    }
+    safe_free((void**)&map->buckets);
+    map->buckets = buckets;
+    map->capacity = capacity;
+    for (MapNode* node = map->root->next; node != map->root; node = node->next) {
+        Map_indexInsert(map, node);
+    }
+    return true;
+}
+
+// Keeps the load factor under 7/8, Robin Hood probing stays short up to there
+static bool Map_ensureCapacity(Map* map, size_t count) {
+    if (count * 8 <= map->capacity * 7) return true;
+    size_t capacity = map->capacity > 0 ? map->capacity : MAP_MIN_CAPACITY;
+    while (count * 8 > capacity * 7) {
+        capacity *= 2;
+    }
+    return Map_rehash(map, capacity);
+}
+
 Map* Map_create(bool is_key_string) {
     Map* map = calloc(1, sizeof(Map));
     if (!map) {
         error("Failed to allocate memory for Map");
         return NULL;
     }
-    map->root = calloc(1, sizeof(MapNode));
+    NodePool_init(&map->pool, sizeof(MapNode));
+    map->root = NodePool_alloc(&map->pool);
     if (!map->root) {
         error("Failed to allocate memory for MapNode");
         safe_free((void**)&map);
@@ -25,13 +126,16 @@ Map* Map_create(bool is_key_string) {
     map->root->next = map->root;
     map->is_key_string = is_key_string;
     map->size = 0;
+    map->buckets = NULL;
+    map->capacity = 0;
     return map;
 }
 
 void Map_destroy(Map* map) {
     if (!map) return;
-    Map_clear(map);
-    safe_free((void**)&map->root);
+    // Nodes and root all live in the pool chunks, release them in bulk
+    NodePool_release(&map->pool);
+    safe_free((void**)&map->buckets);
     safe_free((void**)&map);
 }
 
@@ -39,22 +143,26 @@ void Map_clear(Map* map) {
     MapNode* node = map->root->next;
     while (node != map->root) {
         MapNode* next = node->next;
-        if (node == map->root && next == map->root) break;
-        safe_free((void**)&node);
+        NodePool_free(&map->pool, node);
         node = next;
     }
     map->size = 0;
     map->root->prev = map->root;
     map->root->next = map->root;
+    if (map->buckets) {
+        memset(map->buckets, 0, map->capacity * sizeof(MapBucket));
+    }
 }
 
 void Map_put(Map* map, void* key, void* value) {
-    if (Map_containsKey(map, key)) {
-        MapNode* curr = Map_find(map, key);
-        curr->value = value;
+    const uint32_t hash = Map_hash(map, key);
+    size_t slot;
+    if (Map_findSlot(map, key, hash, &slot)) {
+        map->buckets[slot].node->value = value;
         return;
     }
-    MapNode* node = calloc(1, sizeof(MapNode));
+    if (!Map_ensureCapacity(map, map->size + 1)) return;
+    MapNode* node = NodePool_alloc(&map->pool);
     if (!node) {
         error("Failed to allocate memory for MapNode");
         return;
@@ -63,9 +171,11 @@ void Map_put(Map* map, void* key, void* value) {
     map->root->prev = node;
     node->key = key;
     node->value = value;
+    node->hash = hash;
     node->prev = last;
     node->next = map->root;
     last->next = node;
+    Map_indexInsert(map, node);
     map->size++;
 }
 
@@ -78,18 +188,9 @@ void* Map_get(Map* map, void* key) {
 }
 
 MapNode* Map_find(Map* map, void* key) {
-    MapNode* node = map->root->next;
-    while (node != map->root) {
-        if (map->is_key_string) {
-            if (String_equals(node->key, key)) {
-                return node;
-            }
-        } else {
-            if (node->key == key) {
-                return node;
-            }
-        }
-        node = node->next;
+    size_t slot;
+    if (Map_findSlot(map, key, Map_hash(map, key), &slot)) {
+        return map->buckets[slot].node;
     }
     return NULL;
 }
@@ -110,18 +211,25 @@ bool Map_containsValue(Map* map, void* value) {
 }
 
 void Map_remove(Map* map, void* key) {
-    MapNode* node = Map_find(map, key);
-    if (!node) {
+    size_t slot;
+    if (!Map_findSlot(map, key, Map_hash(map, key), &slot)) {
         return;
     }
+    MapNode* node = map->buckets[slot].node;
+    Map_indexRemove(map, slot);
     MapNode* prev = node->prev;
     MapNode* next = node->next;
     prev->next = next;
     next->prev = prev;
-    safe_free((void**)&node);
+    NodePool_free(&map->pool, node);
     map->size--;
 }
 
+void Map_reserve(Map* map, size_t count) {
+    if (!map) return;
+    Map_ensureCapacity(map, count);
+}
+
 size_t Map_size(Map* map) {
     return map->size;
 }
@@ -130,8 +238,13 @@ bool Map_isEmpty(Map* map) {
     return map->size == 0;
 }
 
+NodePoolStats Map_poolStats(Map* map) {
+    return NodePool_getStats(&map->pool);
+}
+
 char* Map_toString(Map* map, const char* keyFormat, const char* valueFormat, void* (*formatKeyFunc)(void* key), void* (*formatValueFunc)(void* value)) {
-    StringBuilder* sb = StringBuilder_create(DEFAULT_CAPACITY);
+    StringBuilder* sb = StringBuilder_acquire();
+    if (!sb) return NULL;
     StringBuilder_append(sb, "{");
     MapNode* node = map->root->next;
     while (node != map->root) {
@@ -156,18 +269,25 @@ char* Map_toString(Map* map, const char* keyFormat, const char* valueFormat, voi
     }
     StringBuilder_append(sb, "}");
     char* result = StringBuilder_build(sb);
-    StringBuilder_destroy(sb);
+    StringBuilder_release(sb);
     return result;
 }
 
+MapIterator MapIterator_of(Map* map) {
+    return (MapIterator) {
+        .root = map->root,
+        .current = map->root,
+        .next = map->root->next
+    };
+}
+
 MapIterator* MapIterator_new(Map* map) {
     MapIterator* iterator = calloc(1, sizeof(MapIterator));
     if (!iterator) {
         error("Failed to allocate memory for MapIterator");
         return NULL;
     }
-    iterator->root = map->root;
-    iterator->current = map->root;
+    *iterator = MapIterator_of(map);
     return iterator;
 }
 
@@ -177,12 +297,14 @@ void MapIterator_destroy(MapIterator* iterator) {
 }
 
 bool MapIterator_hasNext(MapIterator* iterator) {
-    return iterator->current->next != iterator->root;
+    return iterator->next != iterator->root;
 }
 
+// The following node is fetched ahead so the current key can be removed while iterating
 void MapIterator_next(MapIterator* iterator) {
     if (MapIterator_hasNext(iterator)) {
-        iterator->current = iterator->current->next;
+        iterator->current = iterator->next;
+        iterator->next = iterator->current->next;
     }
 }
 
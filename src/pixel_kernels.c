@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "pixel_kernels.h"
+
+#include "logger.h"
+
+#if PIXEL_KERNELS_X86
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define PIXEL_TARGET_SSE2 __attribute__((target("sse2")))
+#    define PIXEL_TARGET_AVX2 __attribute__((target("avx2")))
+#  else
+#    define PIXEL_TARGET_SSE2
+#    define PIXEL_TARGET_AVX2
+#  endif
+#endif
+
+static const PixelKernels* current;
+
+// Exact round(x / 255) for x <= 255 * 255, the SIMD kernels use the same formula on 16-bit lanes
+INLINE Uint32 Pixel_div255(Uint32 x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// Source channels with an alpha of 255, so the alpha channel ends up as a + dst * (255 - a) / 255
+INLINE void Pixel_mix(Uint8* d, const Uint32 s[4], Uint32 a) {
+    const Uint32 inv = 255 - a;
+    for (int c = 0; c < 4; c++) {
+        d[c] = (Uint8)Pixel_div255(s[c] * a + d[c] * inv);
+    }
+}
+
+static void Scalar_fill(Uint32* dst, int count, SDL_Color color) {
+    Uint32 value;
+    memcpy(&value, &color, sizeof(value));
+    for (int i = 0; i < count; i++) {
+        dst[i] = value;
+    }
+}
+
+static void Scalar_blendColor(Uint32* dst, int count, SDL_Color color) {
+    const Uint32 s[4] = { color.r, color.g, color.b, 255 };
+    for (int i = 0; i < count; i++) {
+        Pixel_mix((Uint8*)&dst[i], s, color.a);
+    }
+}
+
+static void Scalar_blendMask(Uint32* dst, const Uint32* src, int count, SDL_Color color) {
+    const Uint32 s[4] = { color.r, color.g, color.b, 255 };
+    for (int i = 0; i < count; i++) {
+        const Uint8* t = (const Uint8*)&src[i];
+        Pixel_mix((Uint8*)&dst[i], s, Pixel_div255(t[3] * color.a));
+    }
+}
+
+static void Scalar_blendTexture(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    for (int i = 0; i < count; i++) {
+        const Uint8* t = (const Uint8*)&src[i];
+        const Uint32 s[4] = { Pixel_div255(t[0] * tint.r), Pixel_div255(t[1] * tint.g), Pixel_div255(t[2] * tint.b), 255 };
+        Pixel_mix((Uint8*)&dst[i], s, Pixel_div255(t[3] * tint.a));
+    }
+}
+
+static void Scalar_blendPremultiplied(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    for (int i = 0; i < count; i++) {
+        const Uint8* t = (const Uint8*)&src[i];
+        Uint8* d = (Uint8*)&dst[i];
+        const Uint32 a = Pixel_div255(t[3] * tint.a);
+        const Uint32 s[4] = { Pixel_div255(t[0] * tint.r), Pixel_div255(t[1] * tint.g), Pixel_div255(t[2] * tint.b), a };
+        const Uint32 inv = 255 - a;
+        for (int c = 0; c < 4; c++) {
+            // A premultiplied channel never exceeds alpha, the clamp keeps every sum in 16 bits
+            const Uint32 channel = s[c] < a ? s[c] : a;
+            d[c] = (Uint8)Pixel_div255(channel * 255 + d[c] * inv);
+        }
+    }
+}
+
+static const PixelKernels scalarKernels = {
+    "scalar", Scalar_fill, Scalar_blendColor, Scalar_blendMask, Scalar_blendTexture, Scalar_blendPremultiplied
+};
+
+#if PIXEL_KERNELS_X86
+
+/*
+ * 4 (SSE2) or 8 (AVX2) pixels at a time, widened to one 16-bit lane per channel. Every product fits
+ * in 16 bits (255 * 255), the leftover pixels of a span go through the scalar kernels.
+ */
+
+PIXEL_TARGET_SSE2 static inline __m128i Sse2_div255(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+PIXEL_TARGET_SSE2 static inline __m128i Sse2_mix(__m128i s, __m128i a, __m128i d) {
+    const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    return Sse2_div255(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, inv)));
+}
+
+// Every lane of a pixel receives its alpha lane
+PIXEL_TARGET_SSE2 static inline __m128i Sse2_alphas(__m128i x) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+PIXEL_TARGET_SSE2 static void Sse2_fill(Uint32* dst, int count, SDL_Color color) {
+    Uint32 value;
+    memcpy(&value, &color, sizeof(value));
+    const __m128i v = _mm_set1_epi32((int)value);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)&dst[i], v);
+    }
+    Scalar_fill(dst + i, count - i, color);
+}
+
+PIXEL_TARGET_SSE2 static void Sse2_blendColor(Uint32* dst, int count, SDL_Color color) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i s = _mm_setr_epi16(color.r, color.g, color.b, 255, color.r, color.g, color.b, 255);
+    const __m128i a = _mm_set1_epi16(color.a);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+        const __m128i lo = Sse2_mix(s, a, _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = Sse2_mix(s, a, _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+    Scalar_blendColor(dst + i, count - i, color);
+}
+
+PIXEL_TARGET_SSE2 static void Sse2_blendMask(Uint32* dst, const Uint32* src, int count, SDL_Color color) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i s = _mm_setr_epi16(color.r, color.g, color.b, 255, color.r, color.g, color.b, 255);
+    const __m128i colorAlpha = _mm_set1_epi16(color.a);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i t = _mm_loadu_si128((const __m128i*)&src[i]);
+        const __m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+        const __m128i aLo = Sse2_div255(_mm_mullo_epi16(Sse2_alphas(_mm_unpacklo_epi8(t, zero)), colorAlpha));
+        const __m128i aHi = Sse2_div255(_mm_mullo_epi16(Sse2_alphas(_mm_unpackhi_epi8(t, zero)), colorAlpha));
+        const __m128i lo = Sse2_mix(s, aLo, _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = Sse2_mix(s, aHi, _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+    Scalar_blendMask(dst + i, src + i, count - i, color);
+}
+
+PIXEL_TARGET_SSE2 static inline __m128i Sse2_texture(__m128i t, __m128i tint, __m128i d) {
+    const __m128i rgbMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+    const __m128i opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    const __m128i m = Sse2_div255(_mm_mullo_epi16(t, tint));
+    const __m128i s = _mm_or_si128(_mm_and_si128(m, rgbMask), opaque);
+    return Sse2_mix(s, Sse2_alphas(m), d);
+}
+
+PIXEL_TARGET_SSE2 static void Sse2_blendTexture(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tint16 = _mm_setr_epi16(tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i t = _mm_loadu_si128((const __m128i*)&src[i]);
+        const __m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+        const __m128i lo = Sse2_texture(_mm_unpacklo_epi8(t, zero), tint16, _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = Sse2_texture(_mm_unpackhi_epi8(t, zero), tint16, _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+    Scalar_blendTexture(dst + i, src + i, count - i, tint);
+}
+
+PIXEL_TARGET_SSE2 static inline __m128i Sse2_premultiplied(__m128i t, __m128i tint, __m128i d) {
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i m = Sse2_div255(_mm_mullo_epi16(t, tint));
+    const __m128i a = Sse2_alphas(m);
+    const __m128i s = _mm_min_epi16(m, a);
+    const __m128i inv = _mm_sub_epi16(full, a);
+    return Sse2_div255(_mm_add_epi16(_mm_mullo_epi16(s, full), _mm_mullo_epi16(d, inv)));
+}
+
+PIXEL_TARGET_SSE2 static void Sse2_blendPremultiplied(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tint16 = _mm_setr_epi16(tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i t = _mm_loadu_si128((const __m128i*)&src[i]);
+        const __m128i d = _mm_loadu_si128((const __m128i*)&dst[i]);
+        const __m128i lo = Sse2_premultiplied(_mm_unpacklo_epi8(t, zero), tint16, _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = Sse2_premultiplied(_mm_unpackhi_epi8(t, zero), tint16, _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i*)&dst[i], _mm_packus_epi16(lo, hi));
+    }
+    Scalar_blendPremultiplied(dst + i, src + i, count - i, tint);
+}
+
+static const PixelKernels sse2Kernels = {
+    "sse2", Sse2_fill, Sse2_blendColor, Sse2_blendMask, Sse2_blendTexture, Sse2_blendPremultiplied
+};
+
+// Same as SSE2 on both 128-bit halves, unpack and pack work per half so the pixel order is kept
+PIXEL_TARGET_AVX2 static inline __m256i Avx2_div255(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+PIXEL_TARGET_AVX2 static inline __m256i Avx2_mix(__m256i s, __m256i a, __m256i d) {
+    const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+    return Avx2_div255(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, inv)));
+}
+
+PIXEL_TARGET_AVX2 static inline __m256i Avx2_alphas(__m256i x) {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+PIXEL_TARGET_AVX2 static void Avx2_fill(Uint32* dst, int count, SDL_Color color) {
+    Uint32 value;
+    memcpy(&value, &color, sizeof(value));
+    const __m256i v = _mm256_set1_epi32((int)value);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)&dst[i], v);
+    }
+    Scalar_fill(dst + i, count - i, color);
+}
+
+PIXEL_TARGET_AVX2 static void Avx2_blendColor(Uint32* dst, int count, SDL_Color color) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i s = _mm256_setr_epi16(color.r, color.g, color.b, 255, color.r, color.g, color.b, 255,
+        color.r, color.g, color.b, 255, color.r, color.g, color.b, 255);
+    const __m256i a = _mm256_set1_epi16(color.a);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+        const __m256i lo = Avx2_mix(s, a, _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = Avx2_mix(s, a, _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+    }
+    Scalar_blendColor(dst + i, count - i, color);
+}
+
+PIXEL_TARGET_AVX2 static void Avx2_blendMask(Uint32* dst, const Uint32* src, int count, SDL_Color color) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i s = _mm256_setr_epi16(color.r, color.g, color.b, 255, color.r, color.g, color.b, 255,
+        color.r, color.g, color.b, 255, color.r, color.g, color.b, 255);
+    const __m256i colorAlpha = _mm256_set1_epi16(color.a);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i t = _mm256_loadu_si256((const __m256i*)&src[i]);
+        const __m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+        const __m256i aLo = Avx2_div255(_mm256_mullo_epi16(Avx2_alphas(_mm256_unpacklo_epi8(t, zero)), colorAlpha));
+        const __m256i aHi = Avx2_div255(_mm256_mullo_epi16(Avx2_alphas(_mm256_unpackhi_epi8(t, zero)), colorAlpha));
+        const __m256i lo = Avx2_mix(s, aLo, _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = Avx2_mix(s, aHi, _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+    }
+    Scalar_blendMask(dst + i, src + i, count - i, color);
+}
+
+PIXEL_TARGET_AVX2 static inline __m256i Avx2_texture(__m256i t, __m256i tint, __m256i d) {
+    const __m256i rgbMask = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0);
+    const __m256i opaque = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    const __m256i m = Avx2_div255(_mm256_mullo_epi16(t, tint));
+    const __m256i s = _mm256_or_si256(_mm256_and_si256(m, rgbMask), opaque);
+    return Avx2_mix(s, Avx2_alphas(m), d);
+}
+
+PIXEL_TARGET_AVX2 static void Avx2_blendTexture(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i tint16 = _mm256_setr_epi16(tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a,
+        tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i t = _mm256_loadu_si256((const __m256i*)&src[i]);
+        const __m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+        const __m256i lo = Avx2_texture(_mm256_unpacklo_epi8(t, zero), tint16, _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = Avx2_texture(_mm256_unpackhi_epi8(t, zero), tint16, _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+    }
+    Scalar_blendTexture(dst + i, src + i, count - i, tint);
+}
+
+PIXEL_TARGET_AVX2 static inline __m256i Avx2_premultiplied(__m256i t, __m256i tint, __m256i d) {
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i m = Avx2_div255(_mm256_mullo_epi16(t, tint));
+    const __m256i a = Avx2_alphas(m);
+    const __m256i s = _mm256_min_epi16(m, a);
+    const __m256i inv = _mm256_sub_epi16(full, a);
+    return Avx2_div255(_mm256_add_epi16(_mm256_mullo_epi16(s, full), _mm256_mullo_epi16(d, inv)));
+}
+
+PIXEL_TARGET_AVX2 static void Avx2_blendPremultiplied(Uint32* dst, const Uint32* src, int count, SDL_Color tint) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i tint16 = _mm256_setr_epi16(tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a,
+        tint.r, tint.g, tint.b, tint.a, tint.r, tint.g, tint.b, tint.a);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i t = _mm256_loadu_si256((const __m256i*)&src[i]);
+        const __m256i d = _mm256_loadu_si256((const __m256i*)&dst[i]);
+        const __m256i lo = Avx2_premultiplied(_mm256_unpacklo_epi8(t, zero), tint16, _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = Avx2_premultiplied(_mm256_unpackhi_epi8(t, zero), tint16, _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256((__m256i*)&dst[i], _mm256_packus_epi16(lo, hi));
+    }
+    Scalar_blendPremultiplied(dst + i, src + i, count - i, tint);
+}
+
+static const PixelKernels avx2Kernels = {
+    "avx2", Avx2_fill, Avx2_blendColor, Avx2_blendMask, Avx2_blendTexture, Avx2_blendPremultiplied
+};
+
+#endif
+
+static const PixelKernels* PixelKernels_for(PixelKernelsLevel level) {
+    switch (level) {
+        case PIXEL_KERNELS_SCALAR:
+            return &scalarKernels;
+#if PIXEL_KERNELS_X86
+        case PIXEL_KERNELS_SSE2:
+            return SDL_HasSSE2() ? &sse2Kernels : NULL;
+        case PIXEL_KERNELS_AVX2:
+            return SDL_HasAVX2() ? &avx2Kernels : NULL;
+        case PIXEL_KERNELS_AUTO:
+            if (SDL_HasAVX2()) return &avx2Kernels;
+            if (SDL_HasSSE2()) return &sse2Kernels;
+            return &scalarKernels;
+#else
+        case PIXEL_KERNELS_AUTO:
+            return &scalarKernels;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+const PixelKernels* PixelKernels_get() {
+    if (!current) {
+        current = PixelKernels_for(PIXEL_KERNELS_AUTO);
+    }
+    return current;
+}
+
+bool PixelKernels_select(PixelKernelsLevel level) {
+    const PixelKernels* kernels = PixelKernels_for(level);
+    if (!kernels) {
+        log_message(LOG_LEVEL_WARN, "Pixel kernels level %d is not supported by this CPU", (int)level);
+        return false;
+    }
+    current = kernels;
+    return true;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "pool.h"
+
+#include "logger.h"
+#include "utils.h"
+
+typedef struct NodeChunk {
+    struct NodeChunk* next;
+    size_t blocks;
+} NodeChunk;
+
+// Aggregated over every pool, only meant for reporting
+static NodePoolStats globalStats = { 0 };
+
+void NodePool_init(NodePool* pool, size_t blockSize) {
+    const size_t align = sizeof(void*);
+    if (blockSize < sizeof(void*)) {
+        blockSize = sizeof(void*);
+    }
+    pool->blockSize = (blockSize + align - 1) & ~(align - 1);
+    pool->nextChunkBlocks = NODE_POOL_MIN_CHUNK;
+    pool->freeList = NULL;
+    pool->chunks = NULL;
+    pool->stats = (NodePoolStats){ 0 };
+}
+
+void NodePool_release(NodePool* pool) {
+    if (!pool) return;
+    NodeChunk* chunk = pool->chunks;
+    while (chunk) {
+        NodeChunk* next = chunk->next;
+        safe_free((void**)&chunk);
+        chunk = next;
+    }
+    globalStats.live -= pool->stats.live;
+    pool->chunks = NULL;
+    pool->freeList = NULL;
+    pool->nextChunkBlocks = NODE_POOL_MIN_CHUNK;
+    pool->stats.live = 0;
+}
+
+static bool NodePool_grow(NodePool* pool) {
+    const size_t blocks = pool->nextChunkBlocks;
+    NodeChunk* chunk = malloc(sizeof(NodeChunk) + blocks * pool->blockSize);
+    if (!chunk) {
+        error("Failed to allocate memory for NodePool chunk");
+        return false;
+    }
+    chunk->blocks = blocks;
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+
+    // Thread the new blocks in address order in front of the freelist
+    char* first = (char*)(chunk + 1);
+    for (size_t i = 0; i < blocks; i++) {
+        void* block = first + i * pool->blockSize;
+        *(void**)block = i + 1 < blocks ? first + (i + 1) * pool->blockSize : pool->freeList;
+    }
+    pool->freeList = first;
+
+    if (pool->nextChunkBlocks < NODE_POOL_MAX_CHUNK) {
+        pool->nextChunkBlocks *= 2;
+    }
+    pool->stats.chunks++;
+    globalStats.chunks++;
+    return true;
+}
+
+void* NodePool_alloc(NodePool* pool) {
+    if (!pool->freeList && !NodePool_grow(pool)) {
+        return NULL;
+    }
+    void* block = pool->freeList;
+    pool->freeList = *(void**)block;
+    memset(block, 0, pool->blockSize);
+
+    pool->stats.allocations++;
+    if (++pool->stats.live > pool->stats.peak) {
+        pool->stats.peak = pool->stats.live;
+    }
+    globalStats.allocations++;
+    if (++globalStats.live > globalStats.peak) {
+        globalStats.peak = globalStats.live;
+    }
+    return block;
+}
+
+void NodePool_free(NodePool* pool, void* block) {
+    if (!pool || !block) return;
+    *(void**)block = pool->freeList;
+    pool->freeList = block;
+    pool->stats.live--;
+    globalStats.live--;
+}
+
+NodePoolStats NodePool_getStats(const NodePool* pool) {
+    return pool->stats;
+}
+
+NodePoolStats NodePool_getGlobalStats() {
+    return globalStats;
+}
+
+void NodePool_logGlobalStats() {
+    log_message(LOG_LEVEL_INFO, "NodePool: %zu live nodes (peak %zu), %zu node allocations served by %zu chunk mallocs",
+        globalStats.live, globalStats.peak, globalStats.allocations, globalStats.chunks);
+}
@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "render_queue.h"
+
+#include "color.h"
+#include "logger.h"
+#include "sort.h"
+#include "utils.h"
+#include "worker_pool.h"
+
+VEC_DEFINE_NAMED(Vec_RenderQueuePtr, RenderQueue*)
+
+static Vec_RenderQueuePtr queues;
+
+static RenderQueue* RenderQueue_create(SDL_Renderer* renderer) {
+    RenderQueue* self = calloc(1, sizeof(RenderQueue));
+    if (!self) {
+        error("Failed to allocate memory for RenderQueue");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->blend = SDL_BLENDMODE_BLEND;
+    return self;
+}
+
+static void RenderQueue_releaseRetired(RenderQueue* self) {
+    for (size_t i = 0; i < self->retired.size; i++) {
+        SDL_DestroyTexture(self->retired.data[i]);
+    }
+    Vec_SDLTexturePtr_clear(&self->retired);
+}
+
+static void RenderQueue_destroy(RenderQueue* self) {
+    if (!self) return;
+    RenderQueue_releaseRetired(self);
+    Vec_SDLTexturePtr_destroy(&self->retired);
+    Vec_SDLVertex_destroy(&self->vertices);
+    Vec_int_destroy(&self->indices);
+    Vec_RenderCommand_destroy(&self->commands);
+    Vec_RenderCommandPtr_destroy(&self->order);
+    Vec_RenderBatch_destroy(&self->batches);
+    Vec_int_destroy(&self->batchStarts);
+    Vec_SDLVertex_destroy(&self->batchVertices);
+    Vec_int_destroy(&self->batchIndices);
+    Vec_RenderSignature_destroy(&self->signatures);
+    Vec_RenderSignature_destroy(&self->previousSignatures);
+    Vec_FramebufferDraw_destroy(&self->draws);
+    safe_free((void**)&self);
+}
+
+RenderQueue* RenderQueue_get(SDL_Renderer* renderer) {
+    if (!renderer) return NULL;
+    for (size_t i = 0; i < queues.size; i++) {
+        if (queues.data[i]->renderer == renderer) {
+            return queues.data[i];
+        }
+    }
+    RenderQueue* self = RenderQueue_create(renderer);
+    if (self && !Vec_RenderQueuePtr_push(&queues, self)) {
+        RenderQueue_destroy(self);
+        return NULL;
+    }
+    return self;
+}
+
+void RenderQueue_destroyAll() {
+    for (size_t i = 0; i < queues.size; i++) {
+        RenderQueue_destroy(queues.data[i]);
+    }
+    Vec_RenderQueuePtr_destroy(&queues);
+}
+
+void RenderQueue_setLayer(RenderQueue* self, int layer) {
+    if (!self) return;
+    self->layer = layer;
+}
+
+void RenderQueue_setBlendMode(RenderQueue* self, SDL_BlendMode blend) {
+    if (!self) return;
+    self->blend = blend;
+}
+
+// Geometric growth, the Vec reserve is exact
+static bool RenderQueue_reserveVertices(Vec_SDLVertex* vertices, size_t extra) {
+    const size_t needed = vertices->size + extra;
+    if (needed <= vertices->capacity) return true;
+    return Vec_SDLVertex_reserve(vertices, needed > vertices->capacity * 2 ? needed : vertices->capacity * 2);
+}
+
+static bool RenderQueue_reserveIndices(Vec_int* indices, size_t extra) {
+    const size_t needed = indices->size + extra;
+    if (needed <= indices->capacity) return true;
+    return Vec_int_reserve(indices, needed > indices->capacity * 2 ? needed : indices->capacity * 2);
+}
+
+static void RenderQueue_push(RenderQueue* self, SDL_Texture* texture, SDL_BlendMode blend, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+    if (!self || !vertices || !indices || vertexCount <= 0 || indexCount <= 0) return;
+    if (!RenderQueue_reserveVertices(&self->vertices, vertexCount) || !RenderQueue_reserveIndices(&self->indices, indexCount)) {
+        error("Failed to allocate memory for render commands");
+        return;
+    }
+
+    float minX = vertices[0].position.x, maxX = minX;
+    float minY = vertices[0].position.y, maxY = minY;
+    for (int i = 1; i < vertexCount; i++) {
+        const SDL_FPoint p = vertices[i].position;
+        if (p.x < minX) minX = p.x;
+        if (p.x > maxX) maxX = p.x;
+        if (p.y < minY) minY = p.y;
+        if (p.y > maxY) maxY = p.y;
+    }
+    const RenderCommand command = {
+        .layer = self->layer,
+        .texture = texture,
+        .blend = blend,
+        .bounds = { minX, minY, maxX - minX, maxY - minY },
+        .firstVertex = (int)self->vertices.size,
+        .vertexCount = vertexCount,
+        .firstIndex = (int)self->indices.size,
+        .indexCount = indexCount
+    };
+    if (!Vec_RenderCommand_push(&self->commands, command)) return;
+    memcpy(&self->vertices.data[self->vertices.size], vertices, vertexCount * sizeof(SDL_Vertex));
+    self->vertices.size += vertexCount;
+    memcpy(&self->indices.data[self->indices.size], indices, indexCount * sizeof(int));
+    self->indices.size += indexCount;
+}
+
+void RenderQueue_fillRect(RenderQueue* self, const SDL_FRect* rect, const Color* color) {
+    if (!self || !rect || !color) return;
+    const SDL_FColor vertexColor = { color->r / 255.0f, color->g / 255.0f, color->b / 255.0f, color->a / 255.0f };
+    const SDL_Vertex vertices[4] = {
+        { .position = { rect->x, rect->y }, .color = vertexColor },
+        { .position = { rect->x + rect->w, rect->y }, .color = vertexColor },
+        { .position = { rect->x + rect->w, rect->y + rect->h }, .color = vertexColor },
+        { .position = { rect->x, rect->y + rect->h }, .color = vertexColor },
+    };
+    static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+    RenderQueue_push(self, NULL, self->blend, vertices, 4, indices, 6);
+}
+
+void RenderQueue_texture(RenderQueue* self, SDL_Texture* texture, const SDL_FRect* src, const SDL_FRect* dst) {
+    if (!self || !texture || !dst) return;
+    float width, height;
+    if (!SDL_GetTextureSize(texture, &width, &height) || width <= 0 || height <= 0) {
+        error("Failed to get texture size : %s", SDL_GetError());
+        return;
+    }
+    SDL_FRect uv = { 0.0f, 0.0f, 1.0f, 1.0f };
+    if (src) {
+        uv = (SDL_FRect){ src->x / width, src->y / height, src->w / width, src->h / height };
+    }
+    SDL_BlendMode blend = SDL_BLENDMODE_BLEND;
+    SDL_GetTextureBlendMode(texture, &blend);
+    const SDL_FColor white = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const SDL_Vertex vertices[4] = {
+        { { dst->x, dst->y }, white, { uv.x, uv.y } },
+        { { dst->x + dst->w, dst->y }, white, { uv.x + uv.w, uv.y } },
+        { { dst->x + dst->w, dst->y + dst->h }, white, { uv.x + uv.w, uv.y + uv.h } },
+        { { dst->x, dst->y + dst->h }, white, { uv.x, uv.y + uv.h } },
+    };
+    static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+    RenderQueue_push(self, texture, blend, vertices, 4, indices, 6);
+}
+
+void RenderQueue_geometry(RenderQueue* self, SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+    if (!self) return;
+    SDL_BlendMode blend = self->blend;
+    if (texture) {
+        SDL_GetTextureBlendMode(texture, &blend);
+    }
+    RenderQueue_push(self, texture, blend, vertices, vertexCount, indices, indexCount);
+}
+
+static int RenderQueue_compareLayer(const void* a, const void* b, void* ctx) {
+    (void)ctx;
+    const int layerA = ((const RenderCommand*)a)->layer;
+    const int layerB = ((const RenderCommand*)b)->layer;
+    return (layerA > layerB) - (layerA < layerB);
+}
+
+static bool RenderQueue_overlaps(SDL_FRect a, SDL_FRect b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static SDL_FRect RenderQueue_union(SDL_FRect a, SDL_FRect b) {
+    const float minX = a.x < b.x ? a.x : b.x;
+    const float minY = a.y < b.y ? a.y : b.y;
+    const float maxX = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    const float maxY = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (SDL_FRect){ minX, minY, maxX - minX, maxY - minY };
+}
+
+// Assigns every command to a batch, walking back over batches it doesn't overlap to find one with its state
+static bool RenderQueue_batch(RenderQueue* self) {
+    Vec_RenderBatch_clear(&self->batches);
+    for (size_t i = 0; i < self->order.size; i++) {
+        RenderCommand* command = self->order.data[i];
+        int target = -1;
+        const int last = (int)self->batches.size - 1;
+        for (int b = last; b >= 0 && b > last - RENDER_QUEUE_LOOKBACK; b--) {
+            const RenderBatch* batch = &self->batches.data[b];
+            if (batch->layer != command->layer) break;
+            if (batch->texture == command->texture && batch->blend == command->blend) {
+                target = b;
+                break;
+            }
+            if (RenderQueue_overlaps(batch->bounds, command->bounds)) break;
+        }
+        if (target < 0) {
+            const RenderBatch batch = { command->layer, command->texture, command->blend, command->bounds, 0, 0, 0 };
+            if (!Vec_RenderBatch_push(&self->batches, batch)) return false;
+            target = (int)self->batches.size - 1;
+        }
+        RenderBatch* batch = &self->batches.data[target];
+        batch->bounds = RenderQueue_union(batch->bounds, command->bounds);
+        batch->commandCount++;
+        batch->vertexCount += command->vertexCount;
+        batch->indexCount += command->indexCount;
+        command->batch = target;
+    }
+    return true;
+}
+
+static void RenderQueue_drawBatch(RenderQueue* self, const RenderBatch* batch, RenderCommand** commands) {
+    Vec_SDLVertex_clear(&self->batchVertices);
+    Vec_int_clear(&self->batchIndices);
+    if (!RenderQueue_reserveVertices(&self->batchVertices, batch->vertexCount) || !RenderQueue_reserveIndices(&self->batchIndices, batch->indexCount)) {
+        error("Failed to allocate memory for a render batch");
+        return;
+    }
+    for (int i = 0; i < batch->commandCount; i++) {
+        const RenderCommand* command = commands[i];
+        const int base = (int)self->batchVertices.size;
+        memcpy(&self->batchVertices.data[base], &self->vertices.data[command->firstVertex], command->vertexCount * sizeof(SDL_Vertex));
+        self->batchVertices.size += command->vertexCount;
+        const int* indices = &self->indices.data[command->firstIndex];
+        int* out = &self->batchIndices.data[self->batchIndices.size];
+        for (int k = 0; k < command->indexCount; k++) {
+            out[k] = indices[k] + base;
+        }
+        self->batchIndices.size += command->indexCount;
+    }
+
+    if (self->target) {
+        Framebuffer_drawGeometry(self->target, &self->targetClip, batch->texture, batch->blend, self->batchVertices.data,
+            (int)self->batchVertices.size, self->batchIndices.data, (int)self->batchIndices.size);
+        self->lastDrawCalls++;
+        return;
+    }
+    // Untextured geometry uses the draw blend mode, only touch it when it changes
+    if (!batch->texture && (!self->blendKnown || self->currentBlend != batch->blend)) {
+        SDL_SetRenderDrawBlendMode(self->renderer, batch->blend);
+        self->currentBlend = batch->blend;
+        self->blendKnown = true;
+    }
+    if (!SDL_RenderGeometry(self->renderer, batch->texture, self->batchVertices.data, (int)self->batchVertices.size,
+            self->batchIndices.data, (int)self->batchIndices.size)) {
+        error("Failed to render batch : %s", SDL_GetError());
+    }
+    self->lastDrawCalls++;
+}
+
+static void RenderQueue_clear(RenderQueue* self) {
+    Vec_SDLVertex_clear(&self->vertices);
+    Vec_int_clear(&self->indices);
+    Vec_RenderCommand_clear(&self->commands);
+    RenderQueue_releaseRetired(self);
+}
+
+void RenderQueue_discard(RenderQueue* self) {
+    if (!self) return;
+    self->lastCommands = 0;
+    self->lastDrawCalls = 0;
+    RenderQueue_clear(self);
+}
+
+void RenderQueue_retireTexture(RenderQueue* self, SDL_Texture* texture) {
+    if (!texture) return;
+    if (!self || self->commands.size == 0) {
+        SDL_DestroyTexture(texture);
+        return;
+    }
+    if (!Vec_SDLTexturePtr_push(&self->retired, texture)) {
+        // Nothing may draw with it anymore, the recorded commands are lost for this frame
+        RenderQueue_clear(self);
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void RenderQueue_flush(RenderQueue* self) {
+    RenderQueue_flushClipped(self, NULL);
+}
+
+void RenderQueue_setTarget(RenderQueue* self, Framebuffer* target, const SDL_Rect* clip) {
+    if (!self) return;
+    self->target = target;
+    if (target) {
+        self->targetClip = clip ? *clip : (SDL_Rect){ 0, 0, target->width, target->height };
+    }
+}
+
+void RenderQueue_flushClipped(RenderQueue* self, const SDL_FRect* clip) {
+    if (!self) return;
+    const size_t count = self->commands.size;
+    self->lastCommands = (int)count;
+    self->lastDrawCalls = 0;
+    if (count == 0) return;
+    // Something else may have changed the draw blend mode since the last flush
+    self->blendKnown = false;
+
+    Vec_RenderCommandPtr_clear(&self->order);
+    if (!Vec_RenderCommandPtr_reserve(&self->order, count * 2)) {
+        RenderQueue_clear(self);
+        return;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        RenderCommand* command = &self->commands.data[i];
+        if (clip && !RenderQueue_overlaps(command->bounds, *clip)) continue;
+        self->order.data[kept++] = command;
+    }
+    self->order.size = kept;
+    if (!Sort_tim((void**)self->order.data, kept, RenderQueue_compareLayer, NULL) || !RenderQueue_batch(self)) {
+        error("Failed to sort render commands");
+        RenderQueue_clear(self);
+        return;
+    }
+
+    // Group the commands by batch, the second half of order receives them in submission order
+    const size_t batchCount = self->batches.size;
+    Vec_int_clear(&self->batchStarts);
+    if (!Vec_int_reserve(&self->batchStarts, batchCount)) {
+        RenderQueue_clear(self);
+        return;
+    }
+    int start = 0;
+    for (size_t b = 0; b < batchCount; b++) {
+        self->batchStarts.data[b] = start;
+        start += self->batches.data[b].commandCount;
+    }
+    self->batchStarts.size = batchCount;
+    RenderCommand** grouped = &self->order.data[count];
+    for (size_t i = 0; i < kept; i++) {
+        RenderCommand* command = self->order.data[i];
+        grouped[self->batchStarts.data[command->batch]++] = command;
+    }
+
+    if (self->target && WorkerPool_size(self->workers) > 1) {
+        // Commands are the draws in batch order, the same triangles in the same order as drawing batches
+        Vec_FramebufferDraw_clear(&self->draws);
+        if (Vec_FramebufferDraw_reserve(&self->draws, kept)) {
+            for (size_t i = 0; i < kept; i++) {
+                const RenderCommand* command = grouped[i];
+                self->draws.data[i] = (FramebufferDraw){
+                    command->texture, command->blend,
+                    &self->vertices.data[command->firstVertex], command->vertexCount,
+                    &self->indices.data[command->firstIndex], command->indexCount
+                };
+            }
+            self->draws.size = kept;
+            Framebuffer_drawList(self->target, &self->targetClip, self->draws.data, (int)kept, self->workers);
+            self->lastDrawCalls = (int)batchCount;
+        }
+        RenderQueue_clear(self);
+        return;
+    }
+    int offset = 0;
+    for (size_t b = 0; b < batchCount; b++) {
+        const RenderBatch* batch = &self->batches.data[b];
+        RenderQueue_drawBatch(self, batch, &grouped[offset]);
+        offset += batch->commandCount;
+    }
+    RenderQueue_clear(self);
+}
+
+static uint64_t RenderQueue_hash(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static RenderSignature RenderQueue_sign(const RenderQueue* self, const RenderCommand* command) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = RenderQueue_hash(hash, &command->layer, sizeof(command->layer));
+    hash = RenderQueue_hash(hash, &command->texture, sizeof(command->texture));
+    hash = RenderQueue_hash(hash, &command->blend, sizeof(command->blend));
+    hash = RenderQueue_hash(hash, &self->vertices.data[command->firstVertex], command->vertexCount * sizeof(SDL_Vertex));
+    hash = RenderQueue_hash(hash, &self->indices.data[command->firstIndex], command->indexCount * sizeof(int));
+    return (RenderSignature){ hash, command->bounds };
+}
+
+static void RenderQueue_addDamage(bool* damaged, SDL_FRect* damage, SDL_FRect bounds) {
+    if (bounds.w <= 0 || bounds.h <= 0) return;
+    *damage = *damaged ? RenderQueue_union(*damage, bounds) : bounds;
+    *damaged = true;
+}
+
+bool RenderQueue_damage(RenderQueue* self, SDL_FRect* damage) {
+    if (!self || !damage) return false;
+    Vec_RenderSignature_clear(&self->signatures);
+    if (!Vec_RenderSignature_reserve(&self->signatures, self->commands.size)) {
+        // Without signatures the next comparison can't be trusted, everything is damaged
+        Vec_RenderSignature_clear(&self->previousSignatures);
+        self->hasPendingDamage = false;
+        *damage = (SDL_FRect){ -1e9f, -1e9f, 2e9f, 2e9f };
+        return true;
+    }
+    for (size_t i = 0; i < self->commands.size; i++) {
+        self->signatures.data[i] = RenderQueue_sign(self, &self->commands.data[i]);
+    }
+    self->signatures.size = self->commands.size;
+
+    // Compared in submission order, an inserted command damages everything recorded after it
+    bool damaged = false;
+    if (self->hasPendingDamage) {
+        RenderQueue_addDamage(&damaged, damage, self->pendingDamage);
+        self->hasPendingDamage = false;
+    }
+    const Vec_RenderSignature* previous = &self->previousSignatures;
+    const Vec_RenderSignature* current = &self->signatures;
+    const size_t common = previous->size < current->size ? previous->size : current->size;
+    for (size_t i = 0; i < common; i++) {
+        const RenderSignature* before = &previous->data[i];
+        const RenderSignature* after = &current->data[i];
+        if (before->hash != after->hash || memcmp(&before->bounds, &after->bounds, sizeof(SDL_FRect)) != 0) {
+            RenderQueue_addDamage(&damaged, damage, before->bounds);
+            RenderQueue_addDamage(&damaged, damage, after->bounds);
+        }
+    }
+    for (size_t i = common; i < previous->size; i++) {
+        RenderQueue_addDamage(&damaged, damage, previous->data[i].bounds);
+    }
+    for (size_t i = common; i < current->size; i++) {
+        RenderQueue_addDamage(&damaged, damage, current->data[i].bounds);
+    }
+
+    const Vec_RenderSignature swap = self->previousSignatures;
+    self->previousSignatures = self->signatures;
+    self->signatures = swap;
+    return damaged;
+}
+
+void RenderQueue_invalidate(RenderQueue* self, const SDL_FRect* rect) {
+    if (!self || !rect) return;
+    RenderQueue_addDamage(&self->hasPendingDamage, &self->pendingDamage, *rect);
+}
@@ -4,9 +4,17 @@
  */
 #include "resource_manager.h"
 
+#include "atom.h"
+#include "framebuffer.h"
+#include "image_atlas.h"
 #include "logger.h"
 #include "utils.h"
 #include "map.h"
+#include "scaled_image_cache.h"
+#include "text.h"
+#include "text_cache.h"
+#include "texture_pool.h"
+#include "widget_skin.h"
 
 ResourceManager* ResourceManager_create(SDL_Renderer* renderer, MIX_Mixer* mixer) {
     ResourceManager* self = calloc(1, sizeof(ResourceManager));
@@ -16,9 +24,17 @@ ResourceManager* ResourceManager_create(SDL_Renderer* renderer, MIX_Mixer* mixer
     }
     self->renderer = renderer;
     self->mixer = mixer;
-    self->texturesCache = Map_create(true);
-    self->fontsCache = Map_create(true);
-    self->soundsCache = Map_create(true);
+    self->texturesCache = Map_create(false);
+    self->fontsCache = Map_create(false);
+    self->soundsCache = Map_create(false);
+    self->spritesCache = Map_create(false);
+    self->imageAtlas = ImageAtlas_create(renderer);
+    self->atlasImages = true;
+    self->scaledImages = ScaledImageCache_create(renderer, self->imageAtlas);
+    self->widgetSkins = WidgetSkinCache_create(renderer, self->imageAtlas);
+    self->textCache = TextCache_create(TEXT_CACHE_DEFAULT_BUDGET);
+    Text_setSharedCache(self->textCache);
+    self->texturePool = TexturePool_create(renderer, TEXTURE_POOL_DEFAULT_BUDGET);
     return self;
 }
 
@@ -26,85 +42,176 @@ void ResourceManager_destroy(ResourceManager* self) {
     if (!self) return;
 
     if (self->texturesCache) {
-        MapIterator* it = MapIterator_new(self->texturesCache);
-        while (MapIterator_hasNext(it)) {
-            MapIterator_next(it);
-            void* key = MapIterator_key(it);
-            void* value = MapIterator_value(it);
-            SDL_DestroyTexture((SDL_Texture*)value);
-            safe_free(&key);
+        MAP_FOREACH(node, self->texturesCache) {
+            SDL_DestroyTexture((SDL_Texture*)node->value);
         }
-        MapIterator_destroy(it);
         Map_destroy(self->texturesCache);
     }
 
+    if (self->spritesCache) {
+        MAP_FOREACH(node, self->spritesCache) {
+            free(node->value);
+        }
+        Map_destroy(self->spritesCache);
+    }
+
+    if (self->widgetSkins) {
+        WidgetSkinCache_logStats(self->widgetSkins);
+        WidgetSkinCache_destroy(self->widgetSkins);
+    }
+
+    if (self->scaledImages) {
+        ScaledImageCache_logStats(self->scaledImages);
+        ScaledImageCache_destroy(self->scaledImages);
+    }
+
+    if (self->imageAtlas) {
+        ImageAtlas_logStats(self->imageAtlas);
+        ImageAtlas_destroy(self->imageAtlas);
+    }
+
     if (self->fontsCache) {
-        MapIterator* it = MapIterator_new(self->fontsCache);
-        while (MapIterator_hasNext(it)) {
-            MapIterator_next(it);
-            void* key = MapIterator_key(it);
-            Map* sizeMap = (Map*)MapIterator_value(it);
-            if (sizeMap && Map_size(sizeMap) > 0) {
-                MapIterator* sizeIt = MapIterator_new(sizeMap);
-                while (MapIterator_hasNext(sizeIt)) {
-                    MapIterator_next(sizeIt);
-                    TTF_Font* font = MapIterator_value(sizeIt);
+        MAP_FOREACH(node, self->fontsCache) {
+            Map* sizeMap = (Map*)node->value;
+            if (sizeMap) {
+                MAP_FOREACH(sizeNode, sizeMap) {
+                    TTF_Font* font = sizeNode->value;
                     if (font) {
                         TTF_CloseFont(font);
                     }
                 }
-                MapIterator_destroy(sizeIt);
                 Map_destroy(sizeMap);
             }
-            safe_free(&key);
         }
-        MapIterator_destroy(it);
         Map_destroy(self->fontsCache);
     }
 
     if (self->soundsCache) {
-        MapIterator* it = MapIterator_new(self->soundsCache);
-        while (MapIterator_hasNext(it)) {
-            MapIterator_next(it);
-            void* key = MapIterator_key(it);
-            void* value = MapIterator_value(it);
-            MIX_DestroyAudio((MIX_Audio*)value);
-            safe_free(&key);
+        MAP_FOREACH(node, self->soundsCache) {
+            MIX_DestroyAudio((MIX_Audio*)node->value);
         }
-        MapIterator_destroy(it);
         Map_destroy(self->soundsCache);
     }
+
+    if (self->textCache) {
+        TextCache_logStats(self->textCache);
+        Text_setSharedCache(NULL);
+        TextCache_destroy(self->textCache);
+    }
+
+    if (self->texturePool) {
+        TexturePool_logStats(self->texturePool);
+        TexturePool_destroy(self->texturePool);
+    }
     safe_free((void**)&self);
 }
 
+// Takes ownership of loaded, the software rasterizer decodes path again only if it ever samples the texture
+static SDL_Texture* ResourceManager_addTexture(ResourceManager* self, Atom atom, const char* path, SDL_Surface* loaded) {
+    SDL_Texture* texture = loaded ? SDL_CreateTextureFromSurface(self->renderer, loaded) : NULL;
+    if (loaded) {
+        SDL_DestroySurface(loaded);
+    }
+    if (!texture) {
+        error("Failed to load texture %s", path);
+        return NULL;
+    }
+    Framebuffer_attachFile(texture, path);
+    Map_put(self->texturesCache, (void*)atom, texture);
+    log_message(LOG_LEVEL_INFO, "Loaded new texture from %s", path);
+    return texture;
+}
+
 SDL_Texture* ResourceManager_getTexture(ResourceManager* self, const char* filename) {
     if (!self || !self->texturesCache || !filename) return NULL;
+    Atom atom = Atom_intern(filename);
 
-    if (Map_containsKey(self->texturesCache, (void*)filename)) {
-        return Map_get(self->texturesCache, (void*)filename);
+    if (Map_containsKey(self->texturesCache, (void*)atom)) {
+        return Map_get(self->texturesCache, (void*)atom);
     }
 
     char* path = malloc(strlen(TEXTURE_PATH) + strlen(filename) + 1);
     sprintf(path, "%s%s", TEXTURE_PATH, filename);
-    SDL_Texture* texture = IMG_LoadTexture(self->renderer, path);
-    if (!texture) {
-        error("Failed to load texture %s", path);
-        safe_free((void**)&path);
-        return NULL;
-    }
-    Map_put(self->texturesCache, Strdup(filename), texture);
-    log_message(LOG_LEVEL_INFO, "Loaded new texture from %s", path);
+    SDL_Texture* texture = ResourceManager_addTexture(self, atom, path, IMG_Load(path));
     safe_free((void**)&path);
     return texture;
 }
 
+static bool ResourceManager_setSprite(SDL_Texture* texture, Sprite* sprite) {
+    float w, h;
+    if (!texture || !SDL_GetTextureSize(texture, &w, &h)) return false;
+    sprite->texture = texture;
+    sprite->source = (SDL_FRect){ 0, 0, w, h };
+    return true;
+}
+
+bool ResourceManager_getSprite(ResourceManager* self, const char* filename, Sprite* sprite) {
+    if (!self || !self->spritesCache || !filename || !sprite) return false;
+    Atom atom = Atom_intern(filename);
+
+    if (Map_containsKey(self->spritesCache, (void*)atom)) {
+        *sprite = *(Sprite*)Map_get(self->spritesCache, (void*)atom);
+        return true;
+    }
+
+    Sprite* cached = malloc(sizeof(Sprite));
+    if (!cached) {
+        error("Failed to allocate memory for Sprite");
+        return false;
+    }
+    bool loaded = false;
+    if (self->atlasImages && self->imageAtlas && !Map_containsKey(self->texturesCache, (void*)atom)) {
+        char* path = malloc(strlen(TEXTURE_PATH) + strlen(filename) + 1);
+        if (!path) {
+            error("Failed to allocate memory for image path");
+            safe_free((void**)&cached);
+            return false;
+        }
+        sprintf(path, "%s%s", TEXTURE_PATH, filename);
+        SDL_Surface* surface = IMG_Load(path);
+        if (!surface) {
+            error("Failed to load image %s", path);
+            safe_free((void**)&path);
+            safe_free((void**)&cached);
+            return false;
+        }
+        if (ImageAtlas_add(self->imageAtlas, surface, cached)) {
+            log_message(LOG_LEVEL_INFO, "Packed new image from %s", path);
+            SDL_DestroySurface(surface);
+            loaded = true;
+        } else {
+            // Too large for the atlas, the decoded pixels become its own texture
+            loaded = ResourceManager_setSprite(ResourceManager_addTexture(self, atom, path, surface), cached);
+            if (!loaded) {
+                safe_free((void**)&path);
+                safe_free((void**)&cached);
+                return false;
+            }
+        }
+        safe_free((void**)&path);
+    }
+    if (!loaded && !ResourceManager_setSprite(ResourceManager_getTexture(self, filename), cached)) {
+        safe_free((void**)&cached);
+        return false;
+    }
+    Map_put(self->spritesCache, (void*)atom, cached);
+    *sprite = *cached;
+    return true;
+}
+
+void ResourceManager_setImageAtlas(ResourceManager* self, bool enabled) {
+    if (!self) return;
+    self->atlasImages = enabled;
+}
+
 TTF_Font* ResourceManager_getFont(ResourceManager* self, const char* filename, int size) {
     if (!self || !self->fontsCache || !filename) return NULL;
+    Atom atom = Atom_intern(filename);
 
-    if (Map_containsKey(self->fontsCache, (void*)filename)) {
-        Map* sizeMap = Map_get(self->fontsCache, (void*)filename);
-        if (Map_containsKey(sizeMap, (void*)(long)size)) {
-            return Map_get(sizeMap, (void*)(long)size);
+    if (Map_containsKey(self->fontsCache, (void*)atom)) {
+        Map* sizeMap = Map_get(self->fontsCache, (void*)atom);
+        if (Map_containsKey(sizeMap, (void*)(intptr_t)size)) {
+            return Map_get(sizeMap, (void*)(intptr_t)size);
         }
     }
 
@@ -117,13 +224,13 @@ TTF_Font* ResourceManager_getFont(ResourceManager* self, const char* filename, i
         return NULL;
     }
 
-    if (Map_containsKey(self->fontsCache, (void*)filename)) {
-        Map* existingFont = Map_get(self->fontsCache, (void*)filename);
-        Map_put(existingFont, (void*)(long)size, font);
+    if (Map_containsKey(self->fontsCache, (void*)atom)) {
+        Map* existingFont = Map_get(self->fontsCache, (void*)atom);
+        Map_put(existingFont, (void*)(intptr_t)size, font);
     } else {
         Map* sizeMap = Map_create(false);
-        Map_put(sizeMap, (void*)(long)size, font);
-        Map_put(self->fontsCache, Strdup(filename), sizeMap);
+        Map_put(sizeMap, (void*)(intptr_t)size, font);
+        Map_put(self->fontsCache, (void*)atom, sizeMap);
         log_message(LOG_LEVEL_INFO, "Loaded new font from %s", path);
     }
     safe_free((void**)&path);
@@ -132,9 +239,10 @@ TTF_Font* ResourceManager_getFont(ResourceManager* self, const char* filename, i
 
 MIX_Audio* ResourceManager_getSound(ResourceManager* self, const char* filename) {
     if (!self || !self->soundsCache || !filename) return NULL;
+    Atom atom = Atom_intern(filename);
 
-    if (Map_containsKey(self->soundsCache, (void*)filename)) {
-        return Map_get(self->soundsCache, (void*)filename);
+    if (Map_containsKey(self->soundsCache, (void*)atom)) {
+        return Map_get(self->soundsCache, (void*)atom);
     }
 
     char* path = malloc(strlen(SOUND_PATH) + strlen(filename) + 1);
@@ -145,7 +253,7 @@ MIX_Audio* ResourceManager_getSound(ResourceManager* self, const char* filename)
         safe_free((void**)&path);
         return NULL;
     }
-    Map_put(self->soundsCache, Strdup(filename), sound);
+    Map_put(self->soundsCache, (void*)atom, sound);
     log_message(LOG_LEVEL_INFO, "Loaded new sound from %s", path);
     safe_free((void**)&path);
     return sound;
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "scaled_image_cache.h"
+
+#include "framebuffer.h"
+#include "logger.h"
+#include "map.h"
+#include "utils.h"
+
+VEC_DEFINE_NAMED(Vec_ScaledImageCachePtr, ScaledImageCache*)
+
+static Vec_ScaledImageCachePtr caches;
+
+ScaledImageCache* ScaledImageCache_create(SDL_Renderer* renderer, ImageAtlas* atlas) {
+    if (!renderer) return NULL;
+    ScaledImageCache* self = calloc(1, sizeof(ScaledImageCache));
+    if (!self) {
+        error("Failed to allocate memory for ScaledImageCache");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->atlas = atlas;
+    self->variants = Map_create(false);
+    if (!Vec_ScaledImageCachePtr_push(&caches, self)) {
+        Map_destroy(self->variants);
+        safe_free((void**)&self);
+        return NULL;
+    }
+    return self;
+}
+
+void ScaledImageCache_destroy(ScaledImageCache* self) {
+    if (!self) return;
+    for (size_t i = 0; i < caches.size; i++) {
+        if (caches.data[i] == self) {
+            caches.data[i] = caches.data[--caches.size];
+            break;
+        }
+    }
+    if (caches.size == 0) {
+        Vec_ScaledImageCachePtr_destroy(&caches);
+    }
+    MAP_FOREACH(node, self->variants) {
+        Vec_ScaledImage* images = node->value;
+        for (size_t i = 0; i < images->size; i++) {
+            if (images->data[i].owned) {
+                SDL_DestroyTexture(images->data[i].sprite.texture);
+            }
+        }
+        Vec_ScaledImage_destroy(images);
+        free(images);
+    }
+    Map_destroy(self->variants);
+    safe_free((void**)&self);
+}
+
+ScaledImageCache* ScaledImageCache_get(SDL_Renderer* renderer) {
+    if (!renderer) return NULL;
+    for (size_t i = 0; i < caches.size; i++) {
+        if (caches.data[i]->renderer == renderer) {
+            return caches.data[i];
+        }
+    }
+    return NULL;
+}
+
+// Largest half octave level still at least scale, so the variant is never enlarged when drawn
+static int ScaledImageCache_level(float scale) {
+    if (scale >= SCALED_IMAGE_MIN_SCALE) return 0;
+    // Clamped before the cast, tiny scales would overflow an int
+    const float level = floorf(-2.f * log2f(scale));
+    return level > (float)SCALED_IMAGE_MAX_LEVEL ? SCALED_IMAGE_MAX_LEVEL : (int)level;
+}
+
+static int ScaledImageCache_levelSize(int size, int level) {
+    const int scaled = (int)ceilf((float)size * exp2f(-0.5f * (float)level));
+    return scaled > 1 ? scaled : 1;
+}
+
+/*
+ * Box filter: every destination pixel averages the source pixels it covers, partly covered ones by
+ * the covered fraction. Colors stay premultiplied by alpha in between so transparent pixels don't
+ * darken the edges.
+ */
+static float ScaledImageCache_coverage(int texel, float start, float end) {
+    const float lo = (float)texel > start ? (float)texel : start;
+    const float hi = (float)(texel + 1) < end ? (float)(texel + 1) : end;
+    return hi - lo;
+}
+
+// Shrinks srcRows rows of rowLength floats to dstRows rows, whole rows at once
+static void ScaledImageCache_filterRows(const float* src, int srcRows, float* dst, int dstRows, size_t rowLength) {
+    const float span = (float)srcRows / (float)dstRows;
+    for (int d = 0; d < dstRows; d++) {
+        const float start = (float)d * span;
+        const float end = start + span;
+        const int last = (int)ceilf(end) < srcRows ? (int)ceilf(end) : srcRows;
+        float* out = dst + (size_t)d * rowLength;
+        memset(out, 0, rowLength * sizeof(float));
+        for (int s = (int)start; s < last; s++) {
+            const float weight = ScaledImageCache_coverage(s, start, end) / span;
+            const float* in = src + (size_t)s * rowLength;
+            for (size_t i = 0; i < rowLength; i++) {
+                out[i] += in[i] * weight;
+            }
+        }
+    }
+}
+
+// Shrinks every row of rows from srcWidth to dstWidth RGBA pixels
+static void ScaledImageCache_filterColumns(const float* src, int srcWidth, float* dst, int dstWidth, int rows) {
+    const float span = (float)srcWidth / (float)dstWidth;
+    for (int y = 0; y < rows; y++) {
+        const float* in = src + (size_t)y * srcWidth * 4;
+        float* out = dst + (size_t)y * dstWidth * 4;
+        for (int d = 0; d < dstWidth; d++) {
+            const float start = (float)d * span;
+            const float end = start + span;
+            const int last = (int)ceilf(end) < srcWidth ? (int)ceilf(end) : srcWidth;
+            float sum[4] = { 0 };
+            for (int s = (int)start; s < last; s++) {
+                const float weight = ScaledImageCache_coverage(s, start, end);
+                for (int c = 0; c < 4; c++) {
+                    sum[c] += in[s * 4 + c] * weight;
+                }
+            }
+            for (int c = 0; c < 4; c++) {
+                out[d * 4 + c] = sum[c] / span;
+            }
+        }
+    }
+}
+
+// Box filters the rect of an RGBA32 surface down to width x height
+static SDL_Surface* ScaledImageCache_resample(const SDL_Surface* surface, SDL_Rect rect, int width, int height) {
+    SDL_Surface* scaled = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    float* pixels = malloc((size_t)rect.w * rect.h * 4 * sizeof(float));
+    float* rows = malloc((size_t)rect.w * height * 4 * sizeof(float));
+    float* filtered = malloc((size_t)width * height * 4 * sizeof(float));
+    if (!scaled || !pixels || !rows || !filtered) {
+        error("Failed to allocate memory for a scaled image");
+        if (scaled) SDL_DestroySurface(scaled);
+        safe_free((void**)&pixels);
+        safe_free((void**)&rows);
+        safe_free((void**)&filtered);
+        return NULL;
+    }
+
+    for (int y = 0; y < rect.h; y++) {
+        const Uint8* row = (const Uint8*)surface->pixels + (size_t)(rect.y + y) * surface->pitch + (size_t)rect.x * 4;
+        float* out = pixels + (size_t)y * rect.w * 4;
+        for (int x = 0; x < rect.w; x++) {
+            const float alpha = (float)row[x * 4 + 3] / 255.f;
+            out[x * 4] = (float)row[x * 4] * alpha;
+            out[x * 4 + 1] = (float)row[x * 4 + 1] * alpha;
+            out[x * 4 + 2] = (float)row[x * 4 + 2] * alpha;
+            out[x * 4 + 3] = alpha;
+        }
+    }
+    ScaledImageCache_filterRows(pixels, rect.h, rows, height, (size_t)rect.w * 4);
+    ScaledImageCache_filterColumns(rows, rect.w, filtered, width, height);
+
+    for (int y = 0; y < height; y++) {
+        Uint8* row = (Uint8*)scaled->pixels + (size_t)y * scaled->pitch;
+        const float* in = filtered + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++) {
+            const float alpha = in[x * 4 + 3];
+            for (int c = 0; c < 3; c++) {
+                const float color = alpha > 0.f ? in[x * 4 + c] / alpha : 0.f;
+                row[x * 4 + c] = (Uint8)fminf(color + 0.5f, 255.f);
+            }
+            row[x * 4 + 3] = (Uint8)fminf(alpha * 255.f + 0.5f, 255.f);
+        }
+    }
+    safe_free((void**)&pixels);
+    safe_free((void**)&rows);
+    safe_free((void**)&filtered);
+    return scaled;
+}
+
+static void ScaledImageCache_build(ScaledImageCache* self, const Sprite* image, ScaledImage* variant) {
+    // Decodes the pixels of a loaded image the first time, they then stay with it
+    FramebufferSource source = { 0 };
+    const bool found = Framebuffer_source(image->texture, &source);
+    const SDL_Surface* surface = source.surface;
+    const SDL_Rect rect = { (int)image->source.x, (int)image->source.y, (int)image->source.w, (int)image->source.h };
+    if (!found || source.mask
+        || rect.x < 0 || rect.y < 0 || rect.w <= 0 || rect.h <= 0 || rect.x + rect.w > surface->w || rect.y + rect.h > surface->h) {
+        self->failed++;
+        return;
+    }
+
+    const int width = ScaledImageCache_levelSize(rect.w, variant->levelX);
+    const int height = ScaledImageCache_levelSize(rect.h, variant->levelY);
+    SDL_Surface* scaled = ScaledImageCache_resample(surface, rect, width, height);
+    if (!scaled) {
+        self->failed++;
+        return;
+    }
+    if (self->atlas && ImageAtlas_add(self->atlas, scaled, &variant->sprite)) {
+        SDL_DestroySurface(scaled);
+        self->packed++;
+    } else {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(self->renderer, scaled);
+        if (!texture) {
+            error("Failed to create scaled image texture : %s", SDL_GetError());
+            SDL_DestroySurface(scaled);
+            self->failed++;
+            return;
+        }
+        SDL_BlendMode blend = SDL_BLENDMODE_BLEND;
+        SDL_GetTextureBlendMode(image->texture, &blend);
+        SDL_SetTextureBlendMode(texture, blend);
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
+        Framebuffer_attachSurface(texture, scaled, false, true);
+        variant->sprite = (Sprite){ texture, { 0, 0, (float)width, (float)height } };
+        variant->owned = true;
+    }
+    self->built++;
+    self->bytes += (size_t)width * height * 4;
+}
+
+Sprite ScaledImageCache_find(ScaledImageCache* self, const Sprite* image, float width, float height) {
+    if (!image) return (Sprite){ NULL, { 0, 0, 0, 0 } };
+    if (!self || !image->texture || image->source.w <= 0 || image->source.h <= 0) return *image;
+    // Nothing to filter for empty or negative sizes, and NaN fails every comparison
+    if (!(width > 0) || !(height > 0)) return *image;
+    const int levelX = ScaledImageCache_level(width / image->source.w);
+    const int levelY = ScaledImageCache_level(height / image->source.h);
+    if (levelX == 0 && levelY == 0) return *image;
+
+    Vec_ScaledImage* images = Map_get(self->variants, image->texture);
+    if (!images) {
+        images = calloc(1, sizeof(Vec_ScaledImage));
+        if (!images) {
+            error("Failed to allocate memory for scaled images");
+            return *image;
+        }
+        Map_put(self->variants, image->texture, images);
+    }
+    for (size_t i = 0; i < images->size; i++) {
+        const ScaledImage* variant = &images->data[i];
+        if (variant->levelX == levelX && variant->levelY == levelY && memcmp(&variant->source, &image->source, sizeof(SDL_FRect)) == 0) {
+            self->hits++;
+            return variant->sprite.texture ? variant->sprite : *image;
+        }
+    }
+
+    ScaledImage variant = { image->source, levelX, levelY, { NULL, { 0, 0, 0, 0 } }, false };
+    ScaledImageCache_build(self, image, &variant);
+    if (!Vec_ScaledImage_push(images, variant)) {
+        if (variant.owned) {
+            SDL_DestroyTexture(variant.sprite.texture);
+        }
+        return *image;
+    }
+    return variant.sprite.texture ? variant.sprite : *image;
+}
+
+void ScaledImageCache_logStats(ScaledImageCache* self) {
+    if (!self) return;
+    log_message(LOG_LEVEL_DEBUG, "Scaled images: %zu variants (%zu packed in the atlas, %zu bytes), %zu failed, %zu hits",
+        self->built, self->packed, self->bytes, self->failed, self->hits);
+}
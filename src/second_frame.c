@@ -5,6 +5,7 @@
 #include "second_frame.h"
 
 #include "app.h"
+#include "arena.h"
 #include "button.h"
 #include "color.h"
 #include "element.h"
@@ -21,10 +22,14 @@
 #include "utils.h"
 
 static void SecondFrame_addElements(SecondFrame* self);
+static void SecondFrame_renderBackground(SDL_Renderer* renderer, SecondFrame* self);
 static void SecondFrame_onButtonClick(Input* input, SDL_Event* evt, void* data);
 static void SecondFrame_onRuneB(Input* input, SDL_Event* evt, void* data);
 static void SecondFrame_onRuneQ(Input* input, SDL_Event* evt, void* data);
 static void SecondFrame_onRuneM(Input* input, SDL_Event* evt, void* data);
+static void SecondFrame_onRuneI(Input* input, SDL_Event* evt, void* data);
+static void SecondFrame_onRuneT(Input* input, SDL_Event* evt, void* data);
+static void SecondFrame_onRuneR(Input* input, SDL_Event* evt, void* data);
 
 SecondFrame* SecondFrame_new(App* app) {
     SecondFrame* self = calloc(1, sizeof(SecondFrame));
@@ -47,18 +52,15 @@ SecondFrame* SecondFrame_new(App* app) {
 }
 
 static void SecondFrame_addElements(SecondFrame* self) {
-    ListIterator* it = ListIterator_new(self->elements);
-    while (ListIterator_hasNext(it)) {
-        Element* element = ListIterator_next(it);
-        Element_destroy(element);
+    LIST_FOREACH(node, self->elements) {
+        Element_destroy(node->value);
     }
-    ListIterator_destroy(it);
     List_clear(self->elements);
     int w, h;
     SDL_GetWindowSize(self->app->window, &w, &h);
 
-    Box* box = Box_new(w, h - 100, 0, Position_new(0, 0), COLOR_BLACK, NULL, false);
-    List_push(self->elements, Element_fromBox(box, NULL));
+    Box_destroy(self->background);
+    self->background = Box_new(w, h - 100, 0, Position_new(0, 0), COLOR_BLACK, NULL, false);
 
     InputBox* input_box = InputBox_new(self->app,
         SDL_CreateRect(w / 4, h - 50, 200, 40),
@@ -84,6 +86,7 @@ void SecondFrame_destroy(SecondFrame* self) {
     if (!self) return;
 
     Element_destroyList(self->elements);
+    Box_destroy(self->background);
 
     if (self->numbers) {
         List_destroy(self->numbers);
@@ -96,26 +99,29 @@ void SecondFrame_destroy(SecondFrame* self) {
     safe_free((void**)&self);
 }
 
+static void SecondFrame_renderBackground(SDL_Renderer* renderer, SecondFrame* self) {
+    Box_render(self->background, renderer);
+}
+
 void SecondFrame_render(SDL_Renderer* renderer, SecondFrame* self) {
     Element_renderList(self->elements, renderer);
     int w, h;
     SDL_GetWindowSize(self->app->window, &w, &h);
 
-    ListIterator* it = ListIterator_new(self->numbers);
-    while (ListIterator_hasNext(it)) {
-        int num = (int) ListIterator_next(it);
-        Text* text = Text_newf(self->app->renderer, TextStyle_new(ResourceManager_getDefaultBoldFont(self->app->manager, 32),
-            32, COLOR_WHITE, TTF_STYLE_NORMAL),
-            Position_new(55 * it->index, h - 150), true, "%d", num);
+    Arena* arena = self->app->frameArena;
+    int index = 0;
+    LIST_FOREACH(node, self->numbers) {
+        int num = (int) (intptr_t) node->value;
+        index++;
+        Text* text = Text_newfIn(arena, self->app->renderer, TextStyle_newIn(arena, ResourceManager_getDefaultBoldFont(self->app->manager, 32),
+            32, Color_rgbIn(arena, 255, 255, 255), TTF_STYLE_NORMAL),
+            Position_newIn(arena, 55 * index, h - 150), true, "%d", num);
         Text_render(text);
 
-        Box* box = Box_new(50, num, 0, Position_new(55 * it->index, h - 150 - (Text_getSize(text).height / 2) - (num / 2)), COLOR_BLUE, NULL, true);
+        Box* box = Box_newIn(arena, 50, num, 0, Position_newIn(arena, 55 * index, h - 150 - (Text_getSize(text).height / 2) - (num / 2)),
+            Color_rgbIn(arena, 0, 0, 255), NULL, true);
         Box_render(box, renderer);
-
-        Text_destroy(text);
-        Box_destroy(box);
     }
-    ListIterator_destroy(it);
 
 }
 
@@ -133,6 +139,9 @@ void SecondFrame_focus(SecondFrame* self) {
     Input_addKeyEventHandler(self->app->input, SDLK_B, SecondFrame_onRuneB, self);
     Input_addKeyEventHandler(self->app->input, SDLK_Q, SecondFrame_onRuneQ, self);
     Input_addKeyEventHandler(self->app->input, SDLK_M, SecondFrame_onRuneM, self);
+    Input_addKeyEventHandler(self->app->input, SDLK_I, SecondFrame_onRuneI, self);
+    Input_addKeyEventHandler(self->app->input, SDLK_T, SecondFrame_onRuneT, self);
+    Input_addKeyEventHandler(self->app->input, SDLK_R, SecondFrame_onRuneR, self);
 }
 
 void SecondFrame_unfocus(SecondFrame* self) {
@@ -141,6 +150,9 @@ void SecondFrame_unfocus(SecondFrame* self) {
     Input_removeOneKeyEventHandler(self->app->input, SDLK_B, self);
     Input_removeOneKeyEventHandler(self->app->input, SDLK_Q, self);
     Input_removeOneKeyEventHandler(self->app->input, SDLK_M, self);
+    Input_removeOneKeyEventHandler(self->app->input, SDLK_I, self);
+    Input_removeOneKeyEventHandler(self->app->input, SDLK_T, self);
+    Input_removeOneKeyEventHandler(self->app->input, SDLK_R, self);
 }
 
 Frame* SecondFrame_getFrame(SecondFrame* self) {
@@ -151,6 +163,7 @@ Frame* SecondFrame_getFrame(SecondFrame* self) {
         (FrameFocusFunc) SecondFrame_unfocus,
         (DestroyFunc) SecondFrame_destroy);
     Frame_setTitle(frame, "SecondFrame");
+    Frame_addLayer(frame, -1, (FrameRenderFunc) SecondFrame_renderBackground, self);
     return frame;
 }
 
@@ -175,41 +188,38 @@ static void SecondFrame_onButtonClick(Input* input, SDL_Event* evt, void* data)
     }
 }
 
-static void SecondFrame_onRuneB(Input* input, SDL_Event* evt, void* data) {
-    SecondFrame *self = data;
+static void SecondFrame_sortWith(SecondFrame* self, ListSortType sortType) {
     if (!self) {
         return;
     }
     Timer_start(self->timer);
-    List_sort(self->numbers, LIST_SORT_TYPE_BUBBLE);
+    List_sort(self->numbers, sortType);
     Uint32 elapsed = Timer_getTicks(self->timer);
     Timer_stop(self->timer);
     Text* text = Element_getById(self->elements, "Time")->data.text;
     Text_setStringf(text, "Time take : %u ms", elapsed);
 }
 
+static void SecondFrame_onRuneB(Input* input, SDL_Event* evt, void* data) {
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_BUBBLE);
+}
+
 static void SecondFrame_onRuneQ(Input* input, SDL_Event* evt, void* data) {
-    SecondFrame *self = data;
-    if (!self) {
-        return;
-    }
-    Timer_start(self->timer);
-    List_sort(self->numbers, LIST_SORT_TYPE_QUICK);
-    Uint32 elapsed = Timer_getTicks(self->timer);
-    Timer_stop(self->timer);
-    Text* text = Element_getById(self->elements, "Time")->data.text;
-    Text_setStringf(text, "Time take : %u ms", elapsed);
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_QUICK);
 }
 
 static void SecondFrame_onRuneM(Input* input, SDL_Event* evt, void* data) {
-    SecondFrame *self = data;
-    if (!self) {
-        return;
-    }
-    Timer_start(self->timer);
-    List_sort(self->numbers, LIST_SORT_TYPE_MERGE);
-    Uint32 elapsed = Timer_getTicks(self->timer);
-    Timer_stop(self->timer);
-    Text* text = Element_getById(self->elements, "Time")->data.text;
-    Text_setStringf(text, "Time take : %u ms", elapsed);
-}
\ No newline at end of file
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_MERGE);
+}
+
+static void SecondFrame_onRuneI(Input* input, SDL_Event* evt, void* data) {
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_INTRO);
+}
+
+static void SecondFrame_onRuneT(Input* input, SDL_Event* evt, void* data) {
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_TIM);
+}
+
+static void SecondFrame_onRuneR(Input* input, SDL_Event* evt, void* data) {
+    SecondFrame_sortWith(data, LIST_SORT_TYPE_RADIX);
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "sort.h"
+
+#include "logger.h"
+#include "utils.h"
+
+#define SORT_MAX_RUNS 85
+
+static inline void Sort_swap(void** a, void** b) {
+    void* tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void Sort_insertion(void** items, size_t count, CompareFunc cmp, void* ctx) {
+    for (size_t i = 1; i < count; i++) {
+        void* value = items[i];
+        size_t j = i;
+        while (j > 0 && cmp(items[j - 1], value, ctx) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = value;
+    }
+}
+
+static void Sort_siftDown(void** items, size_t root, size_t count, CompareFunc cmp, void* ctx) {
+    while (true) {
+        size_t child = root * 2 + 1;
+        if (child >= count) return;
+        if (child + 1 < count && cmp(items[child], items[child + 1], ctx) < 0) {
+            child++;
+        }
+        if (cmp(items[root], items[child], ctx) >= 0) return;
+        Sort_swap(&items[root], &items[child]);
+        root = child;
+    }
+}
+
+static void Sort_heap(void** items, size_t count, CompareFunc cmp, void* ctx) {
+    for (size_t i = count / 2; i-- > 0;) {
+        Sort_siftDown(items, i, count, cmp, ctx);
+    }
+    for (size_t end = count - 1; end > 0; end--) {
+        Sort_swap(&items[0], &items[end]);
+        Sort_siftDown(items, 0, end, cmp, ctx);
+    }
+}
+
+static void Sort_introRec(void** items, size_t count, int depth, CompareFunc cmp, void* ctx) {
+    while (count > SORT_INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            Sort_heap(items, count, cmp, ctx);
+            return;
+        }
+
+        // Median of three moved to the front as the pivot, it also guards both scans
+        size_t mid = count / 2;
+        if (cmp(items[mid], items[0], ctx) < 0) Sort_swap(&items[mid], &items[0]);
+        if (cmp(items[count - 1], items[0], ctx) < 0) Sort_swap(&items[count - 1], &items[0]);
+        if (cmp(items[count - 1], items[mid], ctx) < 0) Sort_swap(&items[count - 1], &items[mid]);
+        Sort_swap(&items[0], &items[mid]);
+        void* pivot = items[0];
+
+        size_t i = 0;
+        size_t j = count;
+        while (true) {
+            do { i++; } while (i < count && cmp(items[i], pivot, ctx) < 0);
+            do { j--; } while (cmp(pivot, items[j], ctx) < 0);
+            if (i >= j) break;
+            Sort_swap(&items[i], &items[j]);
+        }
+        Sort_swap(&items[0], &items[j]);
+
+        // Recurse on the smaller side to keep the stack logarithmic
+        size_t left = j;
+        size_t right = count - j - 1;
+        if (left < right) {
+            Sort_introRec(items, left, depth, cmp, ctx);
+            items += j + 1;
+            count = right;
+        } else {
+            Sort_introRec(items + j + 1, right, depth, cmp, ctx);
+            count = left;
+        }
+    }
+    Sort_insertion(items, count, cmp, ctx);
+}
+
+void Sort_intro(void** items, size_t count, CompareFunc cmp, void* ctx) {
+    if (!items || count < 2 || !cmp) return;
+    int depth = 0;
+    for (size_t n = count; n > 1; n >>= 1) {
+        depth += 2;
+    }
+    Sort_introRec(items, count, depth, cmp, ctx);
+}
+
+static size_t Sort_minRun(size_t count) {
+    size_t bit = 0;
+    while (count >= SORT_MIN_MERGE) {
+        bit |= count & 1;
+        count >>= 1;
+    }
+    return count + bit;
+}
+
+// Inserts items[sorted..count) into the sorted prefix, upper bound search keeps equal items in order
+static void Sort_binaryInsertion(void** items, size_t sorted, size_t count, CompareFunc cmp, void* ctx) {
+    for (size_t i = sorted; i < count; i++) {
+        void* value = items[i];
+        size_t lo = 0;
+        size_t hi = i;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cmp(value, items[mid], ctx) < 0) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        memmove(&items[lo + 1], &items[lo], (i - lo) * sizeof(void*));
+        items[lo] = value;
+    }
+}
+
+static size_t Sort_countRun(void** items, size_t count, CompareFunc cmp, void* ctx) {
+    if (count < 2) return count;
+    size_t run = 2;
+    if (cmp(items[1], items[0], ctx) < 0) {
+        // Only strictly descending runs are reversed, so equal items keep their order
+        while (run < count && cmp(items[run], items[run - 1], ctx) < 0) run++;
+        for (size_t lo = 0, hi = run - 1; lo < hi; lo++, hi--) {
+            Sort_swap(&items[lo], &items[hi]);
+        }
+    } else {
+        while (run < count && cmp(items[run], items[run - 1], ctx) >= 0) run++;
+    }
+    return run;
+}
+
+static void Sort_mergeAt(void** items, void** buffer, size_t start, size_t mid, size_t end, CompareFunc cmp, void* ctx) {
+    // Items of the left run already below the right run's first item, and of the right run above the left's last, stay put
+    size_t lo = start;
+    size_t hi = mid;
+    while (lo < hi) {
+        size_t m = lo + (hi - lo) / 2;
+        if (cmp(items[mid], items[m], ctx) < 0) hi = m; else lo = m + 1;
+    }
+    start = lo;
+    lo = mid;
+    hi = end;
+    while (lo < hi) {
+        size_t m = lo + (hi - lo) / 2;
+        if (cmp(items[m], items[mid - 1], ctx) < 0) lo = m + 1; else hi = m;
+    }
+    end = lo;
+    if (start >= mid || mid >= end) return;
+
+    size_t leftCount = mid - start;
+    size_t rightCount = end - mid;
+    // Only the smaller run is copied out, so the buffer never needs more than half the input
+    if (leftCount <= rightCount) {
+        memcpy(buffer, &items[start], leftCount * sizeof(void*));
+        size_t i = 0;
+        size_t j = mid;
+        size_t k = start;
+        while (i < leftCount && j < end) {
+            if (cmp(items[j], buffer[i], ctx) < 0) {
+                items[k++] = items[j++];
+            } else {
+                items[k++] = buffer[i++];
+            }
+        }
+        memcpy(&items[k], &buffer[i], (leftCount - i) * sizeof(void*));
+    } else {
+        memcpy(buffer, &items[mid], rightCount * sizeof(void*));
+        size_t i = mid;
+        size_t j = rightCount;
+        size_t k = end;
+        while (i > start && j > 0) {
+            if (cmp(buffer[j - 1], items[i - 1], ctx) < 0) {
+                items[--k] = items[--i];
+            } else {
+                items[--k] = buffer[--j];
+            }
+        }
+        memcpy(&items[start], buffer, j * sizeof(void*));
+    }
+}
+
+bool Sort_tim(void** items, size_t count, CompareFunc cmp, void* ctx) {
+    if (!items || count < 2 || !cmp) return true;
+    if (count < SORT_MIN_MERGE) {
+        size_t run = Sort_countRun(items, count, cmp, ctx);
+        Sort_binaryInsertion(items, run, count, cmp, ctx);
+        return true;
+    }
+
+    void** buffer = malloc((count / 2 + 1) * sizeof(void*));
+    if (!buffer) {
+        error("Failed to allocate memory for Sort_tim buffer");
+        return false;
+    }
+
+    size_t runStart[SORT_MAX_RUNS];
+    size_t runLength[SORT_MAX_RUNS];
+    int runs = 0;
+    const size_t minRun = Sort_minRun(count);
+
+    for (size_t start = 0; start < count;) {
+        size_t length = Sort_countRun(items + start, count - start, cmp, ctx);
+        if (length < minRun) {
+            size_t forced = count - start < minRun ? count - start : minRun;
+            Sort_binaryInsertion(items + start, length, forced, cmp, ctx);
+            length = forced;
+        }
+        runStart[runs] = start;
+        runLength[runs] = length;
+        runs++;
+        start += length;
+
+        // Keep the run lengths decreasing like Fibonacci numbers so merges stay balanced
+        while (runs > 1) {
+            int n = runs - 2;
+            if ((n > 0 && runLength[n - 1] <= runLength[n] + runLength[n + 1]) ||
+                (n > 1 && runLength[n - 2] <= runLength[n - 1] + runLength[n])) {
+                if (runLength[n - 1] < runLength[n + 1]) n--;
+            } else if (runLength[n] > runLength[n + 1]) {
+                break;
+            }
+            Sort_mergeAt(items, buffer, runStart[n], runStart[n + 1], runStart[n + 1] + runLength[n + 1], cmp, ctx);
+            runLength[n] += runLength[n + 1];
+            for (int r = n + 1; r < runs - 1; r++) {
+                runStart[r] = runStart[r + 1];
+                runLength[r] = runLength[r + 1];
+            }
+            runs--;
+        }
+    }
+
+    while (runs > 1) {
+        int n = runs - 2;
+        if (n > 0 && runLength[n - 1] < runLength[n + 1]) n--;
+        Sort_mergeAt(items, buffer, runStart[n], runStart[n + 1], runStart[n + 1] + runLength[n + 1], cmp, ctx);
+        runLength[n] += runLength[n + 1];
+        for (int r = n + 1; r < runs - 1; r++) {
+            runStart[r] = runStart[r + 1];
+            runLength[r] = runLength[r + 1];
+        }
+        runs--;
+    }
+    safe_free((void**)&buffer);
+    return true;
+}
+
+typedef struct {
+    uint64_t key;
+    void* item;
+} RadixEntry;
+
+bool Sort_radix(void** items, size_t count, SortKeyFunc key, void* ctx) {
+    if (!items || count < 2 || !key) return true;
+
+    RadixEntry* entries = malloc(count * 2 * sizeof(RadixEntry));
+    if (!entries) {
+        error("Failed to allocate memory for Sort_radix buffer");
+        return false;
+    }
+    RadixEntry* src = entries;
+    RadixEntry* dst = entries + count;
+
+    // Flipping the sign bit makes signed keys sort correctly as unsigned ones
+    size_t histogram[8][256] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        uint64_t k = (uint64_t)key(items[i], ctx) ^ 0x8000000000000000ULL;
+        src[i].key = k;
+        src[i].item = items[i];
+        for (int pass = 0; pass < 8; pass++) {
+            histogram[pass][(k >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    for (int pass = 0; pass < 8; pass++) {
+        size_t* counts = histogram[pass];
+        const int shift = pass * 8;
+        // Every key shares this byte, the pass would not move anything
+        if (counts[(src[0].key >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = counts[b];
+            counts[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < count; i++) {
+            dst[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        RadixEntry* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        items[i] = src[i].item;
+    }
+    safe_free((void**)&entries);
+    return true;
+}
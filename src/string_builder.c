@@ -31,9 +31,14 @@ void StringBuilder_destroy(StringBuilder* builder) {
     safe_free((void**)&builder);
 }
 
+static THREAD_LOCAL struct {
+    StringBuilder* builders[STRING_BUILDER_POOL_SIZE];
+    int count;
+} pool;
+
 static bool StringBuilder_ensure_capacity(StringBuilder* builder, size_t new_len) {
     if (new_len + 1 > builder->capacity) {
-        size_t new_capacity = builder->capacity * 2;
+        size_t new_capacity = builder->capacity > 0 ? builder->capacity * 2 : DEFAULT_CAPACITY;
         while (new_capacity < new_len + 1) {
             new_capacity *= 2;
         }
@@ -74,31 +79,40 @@ void StringBuilder_append_int(StringBuilder* builder, int i) {
     StringBuilder_append(builder, buffer);
 }
 
-void StringBuilder_append_format(StringBuilder* builder, const char* format, ...) {
+void StringBuilder_appendv(StringBuilder* builder, const char* format, va_list args) {
     if (!builder || !format) return;
-    va_list args;
-    va_start(args, format);
-    char buffer[256];
-    int needed = vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
+    // Format straight into the spare capacity, a second pass is only needed when it doesn't fit
+    va_list copy;
+    va_copy(copy, args);
+    size_t available = builder->capacity - builder->length;
+    int needed = vsnprintf(builder->data ? builder->data + builder->length : NULL, available, format, copy);
+    va_end(copy);
     if (needed < 0) {
-        error("StringBuilder_append_format: vsnprintf error");
+        error("StringBuilder_appendv: vsnprintf error");
+        if (builder->data) {
+            builder->data[builder->length] = '\0';
+        }
         return;
     }
-    if ((size_t)needed < sizeof(buffer)) {
-        StringBuilder_append(builder, buffer);
-    } else {
-        char* dynamic_buffer = malloc(needed + 1);
-        if (!dynamic_buffer) {
-            error("Failed to allocate memory for formatted string");
+    size_t new_len = builder->length + (size_t)needed;
+    if ((size_t)needed >= available) {
+        if (!StringBuilder_ensure_capacity(builder, new_len)) {
+            if (builder->data) {
+                builder->data[builder->length] = '\0';
+            }
             return;
         }
-        va_start(args, format);
-        vsnprintf(dynamic_buffer, needed + 1, format, args);
-        va_end(args);
-        StringBuilder_append(builder, dynamic_buffer);
-        safe_free((void**)&dynamic_buffer);
+        vsnprintf(builder->data + builder->length, (size_t)needed + 1, format, args);
     }
+    builder->length = new_len;
+}
+
+void StringBuilder_append_format(StringBuilder* builder, const char* format, ...) {
+    if (!builder || !format) return;
+    va_list args;
+    va_start(args, format);
+    StringBuilder_appendv(builder, format, args);
+    va_end(args);
 }
 
 char* StringBuilder_build(StringBuilder* builder) {
@@ -108,10 +122,28 @@ char* StringBuilder_build(StringBuilder* builder) {
         error("Failed to allocate memory for StringBuilder build result");
         return NULL;
     }
-    memcpy(result, builder->data, builder->length + 1);
+    // A stolen builder has no data until something is appended again
+    memcpy(result, StringBuilder_view(builder), builder->length + 1);
+    return result;
+}
+
+char* StringBuilder_steal(StringBuilder* builder) {
+    if (!builder) return NULL;
+    char* result = builder->data;
+    if (!result) {
+        return Strdup("");
+    }
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
     return result;
 }
 
+const char* StringBuilder_view(StringBuilder* builder) {
+    if (!builder || !builder->data) return "";
+    return builder->data;
+}
+
 void StringBuilder_clear(StringBuilder* builder) {
     if (!builder) return;
     builder->length = 0;
@@ -128,4 +160,21 @@ size_t StringBuilder_length(StringBuilder* builder) {
 size_t StringBuilder_capacity(StringBuilder* builder) {
     if (!builder) return 0;
     return builder->capacity;
-}
\ No newline at end of file
+}
+
+StringBuilder* StringBuilder_acquire() {
+    if (pool.count > 0) {
+        return pool.builders[--pool.count];
+    }
+    return StringBuilder_create(DEFAULT_CAPACITY);
+}
+
+void StringBuilder_release(StringBuilder* builder) {
+    if (!builder) return;
+    if (pool.count == STRING_BUILDER_POOL_SIZE || builder->capacity > STRING_BUILDER_POOL_MAX_CAPACITY) {
+        StringBuilder_destroy(builder);
+        return;
+    }
+    StringBuilder_clear(builder);
+    pool.builders[pool.count++] = builder;
+}
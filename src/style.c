@@ -4,10 +4,22 @@
  */
 #include "style.h"
 
+#include "arena.h"
 #include "logger.h"
 #include "resource_manager.h"
+#include "text_measure.h"
 #include "utils.h"
 
+// Never 0, so a version recorded as 0 always differs
+static Uint32 lastVersion;
+
+static Uint32 Style_nextVersion() {
+    if (++lastVersion == 0) {
+        lastVersion = 1;
+    }
+    return lastVersion;
+}
+
 EdgeInsets* EdgeInsets_new(const float top, const float bottom, const float left, const float right) {
     EdgeInsets* insets = calloc(1, sizeof(EdgeInsets));
     if (!insets) {
@@ -36,6 +48,21 @@ TextStyle* TextStyle_new(TTF_Font* font, int size, Color* color, TTF_FontStyleFl
     text_style->size = size;
     text_style->color = color;
     text_style->style = style;
+    text_style->version = Style_nextVersion();
+    return text_style;
+}
+
+TextStyle* TextStyle_newIn(Arena* arena, TTF_Font* font, int size, Color* color, TTF_FontStyleFlags style) {
+    TextStyle* text_style = Arena_alloc(arena, sizeof(TextStyle));
+    if (!text_style) {
+        error("Failed to allocate arena memory for TextStyle");
+        return NULL;
+    }
+    text_style->font = font;
+    text_style->size = size;
+    text_style->color = color;
+    text_style->style = style;
+    text_style->version = Style_nextVersion();
     return text_style;
 }
 
@@ -55,6 +82,7 @@ TextStyle* TextStyle_default(ResourceManager* resource_manager) {
     style->font = ResourceManager_getDefaultFont(resource_manager, 32);
     style->color = Color_rgb(255, 255, 255);
     style->style = TTF_STYLE_NORMAL;
+    style->version = Style_nextVersion();
     return style;
 }
 
@@ -68,9 +96,28 @@ TextStyle* TextStyle_defaultFromTheme(Theme* theme, ResourceManager* resource_ma
     style->font = ResourceManager_getDefaultFont(resource_manager, style->size);
     style->color = theme->primary;
     style->style = TTF_STYLE_NORMAL;
+    style->version = Style_nextVersion();
     return style;
 }
 
+void TextStyle_touch(TextStyle* style) {
+    if (!style) return;
+    style->version = Style_nextVersion();
+}
+
+Size TextStyle_measure(const TextStyle* style, const char* str) {
+    if (!style || !style->font) return (Size){ 0, 0 };
+    return TextMeasure_string(TextMeasure_get(style->font, style->style), str);
+}
+
+size_t TextStyle_fit(const TextStyle* style, const char* str, float width, float* fitWidth) {
+    if (!style || !style->font) {
+        if (fitWidth) *fitWidth = 0;
+        return 0;
+    }
+    return TextMeasure_fit(TextMeasure_get(style->font, style->style), str, width, fitWidth);
+}
+
 FullStyleColors* FullStyleColors_new(Color* background, Color* border, Color* text) {
     FullStyleColors* colors = calloc(1, sizeof(FullStyleColors));
     if (!colors) {
@@ -80,6 +127,7 @@ FullStyleColors* FullStyleColors_new(Color* background, Color* border, Color* te
     colors->background = background;
     colors->border = border;
     colors->text = text;
+    colors->version = Style_nextVersion();
     return colors;
 }
 
@@ -97,6 +145,11 @@ void FullStyleColors_destroy(FullStyleColors* colors) {
     safe_free((void**)&colors);
 }
 
+void FullStyleColors_touch(FullStyleColors* colors) {
+    if (!colors) return;
+    colors->version = Style_nextVersion();
+}
+
 ButtonStyle* ButtonStyle_new(FullStyleColors* colors, int border_width, TTF_Font* text_font, TTF_FontStyleFlags text_style, int text_size, EdgeInsets* paddings) {
     ButtonStyle* style = calloc(1, sizeof(ButtonStyle));
     if (!style) {
@@ -109,6 +162,7 @@ ButtonStyle* ButtonStyle_new(FullStyleColors* colors, int border_width, TTF_Font
     style->text_style = text_style;
     style->text_size = text_size;
     style->paddings = paddings;
+    style->version = Style_nextVersion();
     return style;
 }
 
@@ -134,6 +188,7 @@ ButtonStyle* ButtonStyle_default(ResourceManager* resource_manager) {
         Color_rgb(100, 100, 100),
         Color_rgb(0, 0, 0));
     style->paddings = EdgeInsets_newSymmetric(10, 20);
+    style->version = Style_nextVersion();
     return style;
 }
 
@@ -152,9 +207,15 @@ ButtonStyle* ButtonStyle_defaultFromTheme(Theme* theme, ResourceManager* resourc
         theme->primary,
         theme->background);
     style->paddings = EdgeInsets_newSymmetric(10, 20);
+    style->version = Style_nextVersion();
     return style;
 }
 
+void ButtonStyle_touch(ButtonStyle* style) {
+    if (!style) return;
+    style->version = Style_nextVersion();
+}
+
 InputBoxStyle* InputBoxStyle_new(TTF_Font* font, int text_size, TTF_FontStyleFlags style, FullStyleColors* colors) {
     InputBoxStyle* self = calloc(1, sizeof(InputBoxStyle));
     if (!self) {
@@ -165,6 +226,8 @@ InputBoxStyle* InputBoxStyle_new(TTF_Font* font, int text_size, TTF_FontStyleFla
     self->text_size = text_size;
     self->style = style;
     self->colors = colors;
+    self->border_width = 2;
+    self->version = Style_nextVersion();
     return self;
 }
 
@@ -180,6 +243,7 @@ InputBoxStyle* InputBoxStyle_default(ResourceManager* resource_manager) {
         error("Failed to allocate memory for default InputBoxStyle");
         return NULL;
     }
+    style->border_width = 2;
     style->text_size = 32;
     style->font = ResourceManager_getDefaultFont(resource_manager, style->text_size);
     style->style = TTF_STYLE_NORMAL;
@@ -187,6 +251,7 @@ InputBoxStyle* InputBoxStyle_default(ResourceManager* resource_manager) {
         Color_rgb(255, 255, 255),
         Color_rgb(0, 0, 0),
         Color_rgb(0, 0, 0));
+    style->version = Style_nextVersion();
     return style;
 }
 
@@ -196,6 +261,7 @@ InputBoxStyle* InputBoxStyle_defaultFromTheme(Theme* theme, ResourceManager* res
         error("Failed to allocate memory for default InputBoxStyle from Theme");
         return NULL;
     }
+    style->border_width = 2;
     style->text_size = 32;
     style->font = ResourceManager_getDefaultFont(resource_manager, style->text_size);
     style->style = TTF_STYLE_NORMAL;
@@ -203,9 +269,15 @@ InputBoxStyle* InputBoxStyle_defaultFromTheme(Theme* theme, ResourceManager* res
         theme->background,
         theme->primary,
         theme->primary);
+    style->version = Style_nextVersion();
     return style;
 }
 
+void InputBoxStyle_touch(InputBoxStyle* style) {
+    if (!style) return;
+    style->version = Style_nextVersion();
+}
+
 Theme* Theme_new(Color* background, Color* primary, Color* secondary, TextStyle* title_style, TextStyle* body_style, ButtonStyle* button_style) {
     Theme* theme = calloc(1, sizeof(Theme));
     if (!theme) {
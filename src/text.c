@@ -4,11 +4,25 @@
  */
 #include "text.h"
 
+#include "arena.h"
+#include "geometry.h"
+#include "glyph_atlas.h"
 #include "logger.h"
+#include "render_queue.h"
+#include "string_builder.h"
 #include "style.h"
+#include "text_cache.h"
 #include "utils.h"
 
-void refreshTexture(Text* self);
+static TextCache* sharedCache;
+
+static void Text_rebuild(Text* self);
+static void Text_releaseRun(Text* self);
+static void Text_syncStyle(Text* self);
+
+void Text_setSharedCache(TextCache* cache) {
+    sharedCache = cache;
+}
 
 Text* Text_new(SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* str) {
     Text* text = calloc(1, sizeof(Text));
@@ -21,15 +35,14 @@ Text* Text_new(SDL_Renderer* renderer, TextStyle* style, Position* position, boo
     text->style = style;
     text->position = position;
     text->fromCenter = fromCenter;
-    text->texture = NULL;
 
-    refreshTexture(text);
+    Text_rebuild(text);
 
     return text;
 }
 
-Text* Text_newf(SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, ...) {
-    Text* text = calloc(1, sizeof(Text));
+static Text* Text_vnewIn(Arena* arena, SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, va_list args) {
+    Text* text = arena ? Arena_alloc(arena, sizeof(Text)) : calloc(1, sizeof(Text));
     if (!text) {
         error("Failed to allocate memory for Text");
         return NULL;
@@ -38,31 +51,45 @@ Text* Text_newf(SDL_Renderer* renderer, TextStyle* style, Position* position, bo
     text->style = style;
     text->position = position;
     text->fromCenter = fromCenter;
-    text->texture = NULL;
-    if (format) {
-        va_list args;
-        va_start(args, format);
-        char buffer[1024];
-        vsnprintf(buffer, sizeof(buffer), format, args);
-        va_end(args);
-        text->text = Strdup(buffer);
+    text->arena = arena;
+    StringBuilder* sb = format ? StringBuilder_acquire() : NULL;
+    if (sb) {
+        StringBuilder_appendv(sb, format, args);
+        text->text = arena ? Arena_strdup(arena, StringBuilder_view(sb)) : StringBuilder_build(sb);
+        StringBuilder_release(sb);
     } else {
-        text->text = Strdup("");
+        text->text = arena ? Arena_strdup(arena, "") : Strdup("");
     }
 
-    refreshTexture(text);
+    Text_rebuild(text);
+
+    return text;
+}
 
+Text* Text_newf(SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    Text* text = Text_vnewIn(NULL, renderer, style, position, fromCenter, format, args);
+    va_end(args);
+    return text;
+}
+
+Text* Text_newfIn(Arena* arena, SDL_Renderer* renderer, TextStyle* style, Position* position, bool fromCenter, const char* format, ...) {
+    if (!arena) return NULL;
+    va_list args;
+    va_start(args, format);
+    Text* text = Text_vnewIn(arena, renderer, style, position, fromCenter, format, args);
+    va_end(args);
     return text;
 }
 
 void Text_destroy(Text* self) {
-    if (!self) return;
+    if (!self || self->arena) return;
 
-    if (self->texture) {
-        SDL_DestroyTexture(self->texture);
-    }
     TextStyle_destroy(self->style);
     Position_destroy(self->position);
+    Text_releaseRun(self);
+    safe_free((void**)&self->vertices);
     safe_free((void**)&(self->text));
     safe_free((void**)&self);
 }
@@ -72,86 +99,206 @@ void Text_setString(Text* self, const char* str) {
         return;
     }
 
-    safe_free((void**)&(self->text));
-    self->text = Strdup(str);
+    if (self->arena) {
+        self->text = Arena_strdup(self->arena, str);
+    } else {
+        safe_free((void**)&(self->text));
+        self->text = Strdup(str);
+    }
 
-    refreshTexture(self);
+    Text_rebuild(self);
 }
 
 void Text_setStringf(Text* self, const char* format, ...) {
     if (!format) return;
+    // Formatted into a pooled builder, an unchanged string costs no allocation at all
+    StringBuilder* sb = StringBuilder_acquire();
+    if (!sb) return;
     va_list args;
     va_start(args, format);
-    char buffer[1024];
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    StringBuilder_appendv(sb, format, args);
     va_end(args);
-    Text_setString(self, buffer);
+    Text_setString(self, StringBuilder_view(sb));
+    StringBuilder_release(sb);
+}
+
+static SDL_FColor Text_vertexColor(Text* self) {
+    const Color* color = self->style->color;
+    if (!color) return (SDL_FColor){ 1.0f, 1.0f, 1.0f, 1.0f };
+    return (SDL_FColor){ color->r / 255.0f, color->g / 255.0f, color->b / 255.0f, color->a / 255.0f };
+}
+
+static void Text_recolor(Text* self) {
+    const SDL_FColor vertexColor = Text_vertexColor(self);
+    for (int i = 0; i < self->quadCount * 4; i++) {
+        self->vertices[i].color = vertexColor;
+    }
 }
 
+// Takes ownership of color, like before: it replaces the style color or is destroyed when identical
 void Text_setColor(Text* self, Color* color) {
-    if (memcmp(&(self->style->color), color, sizeof(Color)) == 0) {
+    if (!color) return;
+    if (self->style->color && memcmp(self->style->color, color, sizeof(Color)) == 0) {
+        Color_destroy(color);
         return;
     }
 
-    if (self->style->color) {
+    if (self->arena) {
+        // The style lives in the arena as well, it keeps an arena copy and the heap color is freed
+        Color* copy = Color_rgbaIn(self->arena, color->r, color->g, color->b, color->a);
+        Color_destroy(color);
+        if (!copy) return;
+        color = copy;
+    } else if (self->style->color) {
         Color_destroy(self->style->color);
     }
 
     self->style->color = color;
-    refreshTexture(self);
+    Text_recolor(self);
+}
+
+void Text_setFont(Text* self, TTF_Font* font, int size, TTF_FontStyleFlags flags) {
+    if (!self || !self->style) return;
+    self->style->font = font;
+    self->style->size = size;
+    self->style->style = flags;
+    Text_syncStyle(self);
 }
 
 void Text_setPosition(Text* self, float x, float y) {
     if (!self->position) {
-        self->position = Position_new(x, y);
+        self->position = self->arena ? Position_newIn(self->arena, x, y) : Position_new(x, y);
     } else {
         self->position->x = x;
         self->position->y = y;
     }
 }
 
-void refreshTexture(Text* self) {
-    if (self->texture) {
-        SDL_DestroyTexture(self->texture);
-        self->texture = NULL;
+static bool Text_reserveQuads(Text* self, int count) {
+    if (count <= self->quadCapacity) return true;
+    const size_t vertexCount = (size_t)count * 4;
+    if (self->arena) {
+        // Arena texts are short lived, the previous buffer is simply abandoned to the arena
+        self->vertices = Arena_alloc(self->arena, vertexCount * sizeof(SDL_Vertex));
+        if (!self->vertices) {
+            self->quadCapacity = 0;
+            return false;
+        }
+    } else {
+        SDL_Vertex* vertices = realloc(self->vertices, vertexCount * sizeof(SDL_Vertex));
+        if (!vertices) {
+            error("Failed to allocate memory for Text geometry");
+            return false;
+        }
+        self->vertices = vertices;
+    }
+    self->quadCapacity = count;
+    return true;
+}
+
+static void Text_releaseRun(Text* self) {
+    if (!self->run) return;
+    if (self->cache) {
+        TextCache_release(self->cache, self->run);
+    } else if (self->ownsRun) {
+        TextRun_destroy(self->run);
     }
-    char* text = self->text;
-    if (String_isNullOrEmpty(self->text)) {
-        // Avoid creating an empty texture
-        text = " ";
+    self->run = NULL;
+    self->cache = NULL;
+    self->ownsRun = false;
+}
+
+// Measures the text again, the glyph run is only built when the text is drawn
+static void Text_rebuild(Text* self) {
+    Text_releaseRun(self);
+    self->placed = false;
+    if (!self->style) return;
+    self->styleVersion = self->style->version;
+    self->builtFont = self->style->font;
+    self->builtFlags = self->style->style;
+    if (self->style->font && !self->custom_size) {
+        self->size = TextStyle_measure(self->style, self->text);
     }
-    TTF_SetFontStyle(self->style->font, self->style->style);
+}
 
-    SDL_Surface *surface = TTF_RenderText_Blended(self->style->font, text, strlen(text), Color_toSDLColor(self->style->color));
-    if (!surface) {
-        error("Failed to create text surface.");
+static void Text_buildRun(Text* self) {
+    if (!self->style || !self->style->font) return;
+    GlyphAtlas* atlas = GlyphAtlas_get(self->renderer, self->style->font, self->style->style);
+    if (!atlas) {
+        error("Failed to get a glyph atlas for text.");
         return;
     }
 
-    self->texture = SDL_CreateTextureFromSurface(self->renderer, surface);
-
-    if (!self->custom_size) {
-        float w, h;
-        SDL_GetTextureSize(self->texture, &w, &h);
-        self->size.width = w;
-        self->size.height = h;
+    const char* str = self->text ? self->text : "";
+    if (sharedCache) {
+        self->run = TextCache_acquire(sharedCache, atlas, self->style->style, str);
+        if (self->arena) {
+            // Borrowed for the frame: released runs are only evicted by TextCache_trim, after the arena reset
+            TextCache_release(sharedCache, self->run);
+        } else {
+            self->cache = sharedCache;
+        }
+    } else {
+        self->run = TextRun_new(self->arena, atlas, self->style->style, str);
+        self->ownsRun = true;
     }
+}
 
-    if (!self->texture) {
-        error("Failed to create text texture.");
-        SDL_DestroySurface(surface);
+// Only a different font or style flags need a new run, anything else is applied to the placed vertices
+static void Text_syncStyle(Text* self) {
+    if (!self->style) return;
+    if (self->style->font != self->builtFont || self->style->style != self->builtFlags) {
+        Text_rebuild(self);
         return;
     }
+    if (self->style->version != self->styleVersion) {
+        self->styleVersion = self->style->version;
+        Text_recolor(self);
+    }
+}
+
+static void Text_place(Text* self, float x, float y) {
+    const TextRun* run = self->run;
+    self->quadCount = 0;
+    if (!Text_reserveQuads(self, run->quadCount)) return;
 
-    SDL_DestroySurface(surface);
+    const float scaleX = run->naturalSize.width > 0 ? self->size.width / run->naturalSize.width : 1.0f;
+    const float scaleY = run->naturalSize.height > 0 ? self->size.height / run->naturalSize.height : 1.0f;
+    const SDL_FColor color = Text_vertexColor(self);
+    for (int i = 0; i < run->quadCount * 4; i++) {
+        self->vertices[i].position.x = x + run->layout[i].x * scaleX;
+        self->vertices[i].position.y = y + run->layout[i].y * scaleY;
+        self->vertices[i].tex_coord = run->texCoords[i];
+        self->vertices[i].color = color;
+    }
+    self->quadCount = run->quadCount;
+    self->placedGeneration = run->generation;
+    self->placedAt = (SDL_FPoint){ x, y };
+    self->placedSize = self->size;
+    self->placed = true;
 }
 
 void Text_render(Text* self) {
-    if (!self || !self->texture) return;
+    if (!self) return;
     if (Position_isNull(self->position)) {
         error("Text position is not set.");
         return;
     }
+    if (self->style && self->style->version != self->styleVersion) {
+        Text_syncStyle(self);
+    }
+    if (!self->run) {
+        Text_buildRun(self);
+    }
+    TextRun* run = self->run;
+    if (!run) return;
+    if (TextRun_refresh(run) || run->generation != self->placedGeneration) {
+        self->placed = false;
+        if (!self->custom_size) {
+            self->size = run->naturalSize;
+        }
+    }
+    if (run->quadCount == 0) return;
 
     float x, y;
     if (self->fromCenter) {
@@ -162,20 +309,33 @@ void Text_render(Text* self) {
         y = self->position->y;
     }
 
-    SDL_FRect dst = { x, y, self->size.width, self->size.height };
-    if (!SDL_RenderTexture(self->renderer, self->texture, NULL, &dst)) {
-        error("Failed to render text texture : %s", SDL_GetError());
+    if (!self->placed || self->placedAt.x != x || self->placedAt.y != y ||
+        self->placedSize.width != self->size.width || self->placedSize.height != self->size.height) {
+        Text_place(self, x, y);
     }
+    if (self->quadCount == 0) return;
+
+    const int* indices = Geometry_quadIndices(self->quadCount);
+    if (!indices) return;
+    RenderQueue_geometry(RenderQueue_get(self->renderer), run->atlas->texture, self->vertices, self->quadCount * 4, indices, self->quadCount * 6);
 }
 
 Size Text_getSize(Text* self) {
     if (!self) return (Size){-1, -1};
+    if (self->style && self->style->version != self->styleVersion) {
+        Text_syncStyle(self);
+    }
     return self->size;
 }
 
+Size Text_measure(Text* self, const char* str) {
+    if (!self) return (Size){-1, -1};
+    return TextStyle_measure(self->style, str ? str : self->text);
+}
+
 void Text_setSize(Text* self, float width, float height) {
     if (!self) return;
     self->custom_size = true;
     self->size.width = width;
     self->size.height = height;
-}
\ No newline at end of file
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "text_cache.h"
+
+#include "arena.h"
+#include "glyph_atlas.h"
+#include "logger.h"
+#include "map.h"
+#include "string_builder.h"
+#include "text_measure.h"
+#include "utils.h"
+
+static size_t layoutCount;
+
+static bool TextRun_reserve(TextRun* run, int count) {
+    if (count <= run->quadCapacity) return true;
+    const size_t pointCount = (size_t)count * 4;
+    if (run->arena) {
+        // Arena runs are short lived, the previous buffers are simply abandoned to the arena
+        run->layout = Arena_alloc(run->arena, pointCount * sizeof(SDL_FPoint));
+        run->texCoords = Arena_alloc(run->arena, pointCount * sizeof(SDL_FPoint));
+        if (!run->layout || !run->texCoords) {
+            run->quadCapacity = 0;
+            return false;
+        }
+    } else {
+        SDL_FPoint* layout = realloc(run->layout, pointCount * sizeof(SDL_FPoint));
+        if (layout) run->layout = layout;
+        SDL_FPoint* texCoords = realloc(run->texCoords, pointCount * sizeof(SDL_FPoint));
+        if (texCoords) run->texCoords = texCoords;
+        if (!layout || !texCoords) {
+            error("Failed to allocate memory for TextRun geometry");
+            return false;
+        }
+    }
+    run->quadCapacity = count;
+    return true;
+}
+
+static void TextRun_addQuad(TextRun* run, SDL_FRect rect, SDL_FRect uv) {
+    SDL_FPoint* layout = &run->layout[run->quadCount * 4];
+    SDL_FPoint* texCoords = &run->texCoords[run->quadCount * 4];
+    layout[0] = (SDL_FPoint){ rect.x, rect.y };
+    layout[1] = (SDL_FPoint){ rect.x + rect.w, rect.y };
+    layout[2] = (SDL_FPoint){ rect.x + rect.w, rect.y + rect.h };
+    layout[3] = (SDL_FPoint){ rect.x, rect.y + rect.h };
+    texCoords[0] = (SDL_FPoint){ uv.x, uv.y };
+    texCoords[1] = (SDL_FPoint){ uv.x + uv.w, uv.y };
+    texCoords[2] = (SDL_FPoint){ uv.x + uv.w, uv.y + uv.h };
+    texCoords[3] = (SDL_FPoint){ uv.x, uv.y + uv.h };
+    run->quadCount++;
+}
+
+// Lays the glyph quads out from the origin, returns false when the atlas changed under it
+static bool TextRun_layoutGlyphs(TextRun* run) {
+    GlyphAtlas* atlas = run->atlas;
+    const Uint32 generation = atlas->generation;
+    const char* str = run->text ? run->text : "";
+    size_t length = strlen(str);
+
+    // One quad per byte is an upper bound on the codepoints, plus underline and strikethrough
+    run->quadCount = 0;
+    if (!TextRun_reserve(run, (int)length + 2)) {
+        return true;
+    }
+
+    float pen = 0.0f;
+    float minX = 0.0f;
+    Uint32 previous = 0;
+    while (length > 0) {
+        Uint32 codepoint = SDL_StepUTF8(&str, &length);
+        if (codepoint == 0) break;
+        const Glyph* found = GlyphAtlas_glyph(atlas, codepoint);
+        if (!found) continue;
+        const Glyph glyph = *found;
+        pen += (float)GlyphAtlas_kerning(atlas, previous, codepoint);
+
+        const float x = pen + (float)glyph.offsetX;
+        const float w = (float)atlas->surface->w;
+        const float h = (float)atlas->surface->h;
+        TextRun_addQuad(run, (SDL_FRect){ x, 0.0f, (float)glyph.rect.w, (float)glyph.rect.h },
+            (SDL_FRect){ glyph.rect.x / w, glyph.rect.y / h, glyph.rect.w / w, glyph.rect.h / h });
+        if (x < minX) minX = x;
+
+        pen += (float)glyph.advance;
+        previous = codepoint;
+    }
+    if (atlas->generation != generation) {
+        return false;
+    }
+
+    // Glyphs hanging left of the pen origin (negative bearing) would be cut, shift everything right
+    if (minX < 0.0f) {
+        for (int i = 0; i < run->quadCount * 4; i++) {
+            run->layout[i].x -= minX;
+        }
+    }
+    // Measured like layout does, so a Text sized before it was drawn keeps its size
+    run->naturalSize = TextMeasure_string(TextMeasure_get(atlas->font, atlas->style), run->text ? run->text : "");
+
+    if (run->lines && run->quadCount > 0) {
+        const SDL_FPoint white = GlyphAtlas_whiteTexel(atlas);
+        const SDL_FRect uv = { white.x, white.y, 0.0f, 0.0f };
+        const float thickness = fmaxf(1.0f, floorf(atlas->lineHeight / 18.0f));
+        if (run->lines & TTF_STYLE_UNDERLINE) {
+            TextRun_addQuad(run, (SDL_FRect){ 0.0f, (float)atlas->ascent + 1.0f, run->naturalSize.width, thickness }, uv);
+        }
+        if (run->lines & TTF_STYLE_STRIKETHROUGH) {
+            TextRun_addQuad(run, (SDL_FRect){ 0.0f, floorf(atlas->ascent * 0.6f), run->naturalSize.width, thickness }, uv);
+        }
+    }
+    return true;
+}
+
+static void TextRun_layout(TextRun* run) {
+    layoutCount++;
+    // A glyph missing from the atlas can make it grow and move the coordinates of the first ones
+    for (int attempt = 0; attempt < 3 && !TextRun_layoutGlyphs(run); attempt++) {
+    }
+    run->generation = run->atlas->generation;
+}
+
+TextRun* TextRun_new(Arena* arena, GlyphAtlas* atlas, TTF_FontStyleFlags lines, const char* str) {
+    if (!atlas) return NULL;
+    TextRun* run = arena ? Arena_alloc(arena, sizeof(TextRun)) : calloc(1, sizeof(TextRun));
+    if (!run) {
+        error("Failed to allocate memory for TextRun");
+        return NULL;
+    }
+    run->arena = arena;
+    run->atlas = atlas;
+    run->lines = lines & GLYPH_ATLAS_LINE_STYLES;
+    run->text = arena ? Arena_strdup(arena, str ? str : "") : Strdup(str ? str : "");
+    TextRun_layout(run);
+    return run;
+}
+
+void TextRun_destroy(TextRun* run) {
+    if (!run || run->arena) return;
+    safe_free((void**)&run->layout);
+    safe_free((void**)&run->texCoords);
+    // Cached runs keep their text inside the key
+    if (run->key) {
+        safe_free((void**)&run->key);
+    } else {
+        safe_free((void**)&run->text);
+    }
+    safe_free((void**)&run);
+}
+
+bool TextRun_refresh(TextRun* run) {
+    if (!run || run->generation == run->atlas->generation) return false;
+    TextRun_layout(run);
+    return true;
+}
+
+size_t TextRun_layoutCount() {
+    return layoutCount;
+}
+
+TextCache* TextCache_create(size_t budget) {
+    TextCache* cache = calloc(1, sizeof(TextCache));
+    if (!cache) {
+        error("Failed to allocate memory for TextCache");
+        return NULL;
+    }
+    cache->runs = Map_create(true);
+    if (!cache->runs) {
+        safe_free((void**)&cache);
+        return NULL;
+    }
+    cache->budget = budget;
+    cache->unused.prev = &cache->unused;
+    cache->unused.next = &cache->unused;
+    return cache;
+}
+
+void TextCache_destroy(TextCache* cache) {
+    if (!cache) return;
+    MAP_FOREACH(node, cache->runs) {
+        TextRun* run = node->value;
+        if (run->refCount > 0) {
+            log_message(LOG_LEVEL_WARN, "Text run \"%s\" still has %d references", run->text, run->refCount);
+        }
+        TextRun_destroy(run);
+    }
+    Map_destroy(cache->runs);
+    safe_free((void**)&cache);
+}
+
+static void TextCache_unlink(TextRun* run) {
+    run->prev->next = run->next;
+    run->next->prev = run->prev;
+    run->prev = NULL;
+    run->next = NULL;
+}
+
+TextRun* TextCache_acquire(TextCache* cache, GlyphAtlas* atlas, TTF_FontStyleFlags lines, const char* str) {
+    if (!cache || !atlas) return NULL;
+    lines &= GLYPH_ATLAS_LINE_STYLES;
+    StringBuilder* sb = StringBuilder_acquire();
+    if (!sb) return NULL;
+    // The atlas already stands for the renderer, the font with its size and the glyph style
+    StringBuilder_append_format(sb, "%p:%x:", (void*)atlas, (unsigned)lines);
+    const size_t prefix = StringBuilder_length(sb);
+    StringBuilder_append(sb, str ? str : "");
+
+    TextRun* run = Map_get(cache->runs, (void*)StringBuilder_view(sb));
+    if (run) {
+        StringBuilder_release(sb);
+        cache->hits++;
+        if (run->refCount++ == 0) {
+            TextCache_unlink(run);
+        }
+        TextRun_refresh(run);
+        return run;
+    }
+
+    cache->misses++;
+    run = calloc(1, sizeof(TextRun));
+    if (!run) {
+        error("Failed to allocate memory for TextRun");
+        StringBuilder_release(sb);
+        return NULL;
+    }
+    run->key = StringBuilder_build(sb);
+    StringBuilder_release(sb);
+    if (!run->key) {
+        safe_free((void**)&run);
+        return NULL;
+    }
+    run->text = run->key + prefix;
+    run->atlas = atlas;
+    run->lines = lines;
+    TextRun_layout(run);
+
+    run->bytes = sizeof(TextRun) + strlen(run->key) + 1 + (size_t)run->quadCapacity * 4 * 2 * sizeof(SDL_FPoint);
+    run->refCount = 1;
+    Map_put(cache->runs, run->key, run);
+    cache->bytes += run->bytes;
+    return run;
+}
+
+void TextCache_release(TextCache* cache, TextRun* run) {
+    if (!cache || !run || run->refCount <= 0) return;
+    if (--run->refCount > 0) return;
+    // Most recently released first, trim evicts from the back
+    run->prev = &cache->unused;
+    run->next = cache->unused.next;
+    cache->unused.next->prev = run;
+    cache->unused.next = run;
+}
+
+void TextCache_trim(TextCache* cache) {
+    if (!cache) return;
+    while (cache->bytes > cache->budget && cache->unused.prev != &cache->unused) {
+        TextRun* run = cache->unused.prev;
+        TextCache_unlink(run);
+        Map_remove(cache->runs, run->key);
+        cache->bytes -= run->bytes;
+        cache->evictions++;
+        TextRun_destroy(run);
+    }
+}
+
+void TextCache_logStats(TextCache* cache) {
+    if (!cache) return;
+    log_message(LOG_LEVEL_DEBUG, "Text cache: %zu runs, %zu/%zu bytes, %zu hits, %zu misses, %zu evictions",
+        Map_size(cache->runs), cache->bytes, cache->budget, cache->hits, cache->misses, cache->evictions);
+}
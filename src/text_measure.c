@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "text_measure.h"
+
+#include "glyph_atlas.h"
+#include "logger.h"
+#include "map.h"
+#include "utils.h"
+
+VEC_DEFINE_NAMED(Vec_TextMeasurePtr, TextMeasure*)
+
+typedef struct {
+    Size size;
+    char text[];
+} TextMeasureEntry;
+
+static Vec_TextMeasurePtr measures;
+static size_t hits;
+static size_t misses;
+
+static void TextMeasure_clear(TextMeasure* measure) {
+    MAP_FOREACH(node, measure->sizes) {
+        free(node->value);
+    }
+    Map_clear(measure->sizes);
+}
+
+static void TextMeasure_destroy(TextMeasure* measure) {
+    if (!measure) return;
+    TextMeasure_clear(measure);
+    Map_destroy(measure->sizes);
+    safe_free((void**)&measure);
+}
+
+TextMeasure* TextMeasure_get(TTF_Font* font, TTF_FontStyleFlags style) {
+    if (!font) return NULL;
+    style &= ~GLYPH_ATLAS_LINE_STYLES;
+    for (size_t i = 0; i < measures.size; i++) {
+        TextMeasure* measure = measures.data[i];
+        if (measure->font == font && measure->style == style) {
+            return measure;
+        }
+    }
+    TextMeasure* measure = calloc(1, sizeof(TextMeasure));
+    if (!measure) {
+        error("Failed to allocate memory for TextMeasure");
+        return NULL;
+    }
+    measure->font = font;
+    measure->style = style;
+    measure->sizes = Map_create(true);
+    if (!measure->sizes || !Vec_TextMeasurePtr_push(&measures, measure)) {
+        TextMeasure_destroy(measure);
+        return NULL;
+    }
+    return measure;
+}
+
+Size TextMeasure_string(TextMeasure* measure, const char* str) {
+    if (!measure) return (Size){ 0, 0 };
+    if (!str) str = "";
+    const TextMeasureEntry* cached = Map_get(measure->sizes, (void*)str);
+    if (cached) {
+        hits++;
+        return cached->size;
+    }
+
+    misses++;
+    int w = 0, h = 0;
+    // The font is shared by every style, the atlases set theirs the same way before rasterizing
+    TTF_SetFontStyle(measure->font, measure->style);
+    if (*str && !TTF_GetStringSize(measure->font, str, 0, &w, &h)) {
+        error("Failed to measure text : %s", SDL_GetError());
+    }
+    // An empty string is still one line high
+    const Size size = { (float)w, (float)(h > 0 ? h : TTF_GetFontHeight(measure->font)) };
+
+    if (Map_size(measure->sizes) >= TEXT_MEASURE_MAX_STRINGS) {
+        TextMeasure_clear(measure);
+    }
+    const size_t length = strlen(str);
+    TextMeasureEntry* entry = malloc(sizeof(TextMeasureEntry) + length + 1);
+    if (entry) {
+        entry->size = size;
+        memcpy(entry->text, str, length + 1);
+        // The string is not cached yet, the map only fails to grow when it is out of memory
+        const size_t count = Map_size(measure->sizes);
+        Map_put(measure->sizes, entry->text, entry);
+        if (Map_size(measure->sizes) == count) {
+            free(entry);
+        }
+    }
+    return size;
+}
+
+size_t TextMeasure_fit(TextMeasure* measure, const char* str, float width, float* fitWidth) {
+    if (fitWidth) *fitWidth = 0;
+    if (!measure || !str || !*str || width <= 0) return 0;
+    int measured = 0;
+    size_t length = 0;
+    TTF_SetFontStyle(measure->font, measure->style);
+    if (!TTF_MeasureString(measure->font, str, 0, (int)width, &measured, &length)) {
+        error("Failed to measure text : %s", SDL_GetError());
+        return 0;
+    }
+    if (fitWidth) *fitWidth = (float)measured;
+    return length;
+}
+
+void TextMeasure_logStats() {
+    size_t strings = 0;
+    for (size_t i = 0; i < measures.size; i++) {
+        strings += Map_size(measures.data[i]->sizes);
+    }
+    log_message(LOG_LEVEL_DEBUG, "Text measures: %zu fonts, %zu strings, %zu hits, %zu misses",
+        measures.size, strings, hits, misses);
+}
+
+void TextMeasure_destroyAll() {
+    for (size_t i = 0; i < measures.size; i++) {
+        TextMeasure_destroy(measures.data[i]);
+    }
+    Vec_TextMeasurePtr_destroy(&measures);
+}
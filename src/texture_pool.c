@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "texture_pool.h"
+
+#include "logger.h"
+#include "utils.h"
+
+VEC_DEFINE_NAMED(Vec_TexturePoolPtr, TexturePool*)
+
+static Vec_TexturePoolPtr pools;
+
+TexturePool* TexturePool_create(SDL_Renderer* renderer, size_t budget) {
+    if (!renderer) return NULL;
+    TexturePool* self = calloc(1, sizeof(TexturePool));
+    if (!self) {
+        error("Failed to allocate memory for TexturePool");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->budget = budget;
+    self->maxSize = (int)SDL_GetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER, 0);
+    if (!Vec_TexturePoolPtr_push(&pools, self)) {
+        safe_free((void**)&self);
+        return NULL;
+    }
+    return self;
+}
+
+void TexturePool_destroy(TexturePool* self) {
+    if (!self) return;
+    for (size_t i = 0; i < pools.size; i++) {
+        if (pools.data[i] == self) {
+            pools.data[i] = pools.data[--pools.size];
+            break;
+        }
+    }
+    if (pools.size == 0) {
+        Vec_TexturePoolPtr_destroy(&pools);
+    }
+    for (size_t i = 0; i < self->idle.size; i++) {
+        SDL_DestroyTexture(self->idle.data[i].texture);
+    }
+    if (self->residentBytes > self->idleBytes) {
+        log_message(LOG_LEVEL_WARN, "Texture pool destroyed with %zu bytes of textures still in use", self->residentBytes - self->idleBytes);
+    }
+    Vec_PooledTexture_destroy(&self->idle);
+    safe_free((void**)&self);
+}
+
+TexturePool* TexturePool_get(SDL_Renderer* renderer) {
+    if (!renderer) return NULL;
+    for (size_t i = 0; i < pools.size; i++) {
+        if (pools.data[i]->renderer == renderer) {
+            return pools.data[i];
+        }
+    }
+    return NULL;
+}
+
+static int TexturePool_sizeClass(const TexturePool* self, int size) {
+    int rounded = TEXTURE_POOL_MIN_SIZE;
+    while (rounded < size) {
+        rounded *= 2;
+    }
+    // Past the renderer limit the texture is as large as it can be, or exactly as asked
+    if (self->maxSize > 0 && rounded > self->maxSize) {
+        rounded = size > self->maxSize ? size : self->maxSize;
+    }
+    return rounded;
+}
+
+SDL_Texture* TexturePool_acquire(SDL_Renderer* renderer, SDL_PixelFormat format, SDL_TextureAccess access, int width, int height) {
+    if (!renderer || width <= 0 || height <= 0) return NULL;
+    TexturePool* self = TexturePool_get(renderer);
+    if (!self) {
+        return SDL_CreateTexture(renderer, format, access, width, height);
+    }
+    const int classWidth = TexturePool_sizeClass(self, width);
+    const int classHeight = TexturePool_sizeClass(self, height);
+    // Most recently released first, their content is the most likely to still be close
+    for (size_t i = self->idle.size; i-- > 0;) {
+        const PooledTexture pooled = self->idle.data[i];
+        if (pooled.format != format || pooled.access != access || pooled.width != classWidth || pooled.height != classHeight) continue;
+        memmove(&self->idle.data[i], &self->idle.data[i + 1], (self->idle.size - i - 1) * sizeof(PooledTexture));
+        self->idle.size--;
+        self->idleBytes -= pooled.bytes;
+        self->hits++;
+        return pooled.texture;
+    }
+
+    self->misses++;
+    SDL_Texture* texture = SDL_CreateTexture(self->renderer, format, access, classWidth, classHeight);
+    if (!texture) {
+        error("Failed to create pooled texture : %s", SDL_GetError());
+        return NULL;
+    }
+    self->residentBytes += (size_t)classWidth * classHeight * SDL_BYTESPERPIXEL(format);
+    if (self->residentBytes > self->peakBytes) {
+        self->peakBytes = self->residentBytes;
+    }
+    return texture;
+}
+
+void TexturePool_release(SDL_Texture* texture) {
+    if (!texture) return;
+    TexturePool* self = TexturePool_get(SDL_GetRendererFromTexture(texture));
+    if (!self) {
+        SDL_DestroyTexture(texture);
+        return;
+    }
+    const SDL_PropertiesID properties = SDL_GetTextureProperties(texture);
+    const SDL_PixelFormat format = (SDL_PixelFormat)SDL_GetNumberProperty(properties, SDL_PROP_TEXTURE_FORMAT_NUMBER, SDL_PIXELFORMAT_UNKNOWN);
+    const int width = (int)SDL_GetNumberProperty(properties, SDL_PROP_TEXTURE_WIDTH_NUMBER, 0);
+    const int height = (int)SDL_GetNumberProperty(properties, SDL_PROP_TEXTURE_HEIGHT_NUMBER, 0);
+    const PooledTexture pooled = {
+        texture, format, (SDL_TextureAccess)SDL_GetNumberProperty(properties, SDL_PROP_TEXTURE_ACCESS_NUMBER, SDL_TEXTUREACCESS_STATIC),
+        width, height, (size_t)width * height * SDL_BYTESPERPIXEL(format)
+    };
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    if (!Vec_PooledTexture_push(&self->idle, pooled)) {
+        self->residentBytes -= pooled.bytes;
+        SDL_DestroyTexture(texture);
+        return;
+    }
+    self->idleBytes += pooled.bytes;
+    size_t evicted = 0;
+    while (self->idleBytes > self->budget && evicted < self->idle.size) {
+        const PooledTexture oldest = self->idle.data[evicted++];
+        SDL_DestroyTexture(oldest.texture);
+        self->idleBytes -= oldest.bytes;
+        self->residentBytes -= oldest.bytes;
+        self->evictions++;
+    }
+    if (evicted > 0) {
+        memmove(self->idle.data, &self->idle.data[evicted], (self->idle.size - evicted) * sizeof(PooledTexture));
+        self->idle.size -= evicted;
+    }
+}
+
+void TexturePool_logStats(TexturePool* self) {
+    if (!self) return;
+    const size_t requests = self->hits + self->misses;
+    log_message(LOG_LEVEL_DEBUG, "Texture pool: %zu hits, %zu misses (%.1f%% hit rate), %zu evictions, %zu bytes resident (%zu idle, %zu peak)",
+        self->hits, self->misses, requests > 0 ? 100.0 * (double)self->hits / (double)requests : 0.0, self->evictions,
+        self->residentBytes, self->idleBytes, self->peakBytes);
+}
@@ -8,6 +8,22 @@
 #include "logger.h"
 #include "utils.h"
 
+static bool fixedClock;
+static Uint64 fixedTicks;
+
+Uint64 Timer_now() {
+    return fixedClock ? fixedTicks : SDL_GetTicks();
+}
+
+void Timer_useFixedClock(Uint64 start) {
+    fixedClock = true;
+    fixedTicks = start;
+}
+
+void Timer_advanceClock(Uint64 ms) {
+    fixedTicks += ms;
+}
+
 Timer* Timer_new() {
     Timer* self = calloc(1, sizeof(Timer));
     if (!self) {
@@ -29,7 +45,7 @@ void Timer_destroy(Timer* self) {
 void Timer_start(Timer* self) {
     self->started = true;
     self->paused = false;
-    self->startTicks = SDL_GetTicks();
+    self->startTicks = Timer_now();
     self->pausedTicks = 0;
 }
 
@@ -43,21 +59,21 @@ void Timer_stop(Timer* self) {
 void Timer_reset(Timer* self) {
     self->paused = false;
     self->started = true;
-    self->startTicks = SDL_GetTicks();
+    self->startTicks = Timer_now();
     self->pausedTicks = 0;
 }
 
 void Timer_pause(Timer* self) {
     if (self->started && !self->paused) {
         self->paused = true;
-        self->pausedTicks = SDL_GetTicks() - self->startTicks;
+        self->pausedTicks = Timer_now() - self->startTicks;
     }
 }
 
 void Timer_resume(Timer* self) {
     if (self->started && self->paused) {
         self->paused = false;
-        self->startTicks = SDL_GetTicks() - self->pausedTicks;
+        self->startTicks = Timer_now() - self->pausedTicks;
         self->pausedTicks = 0;
     }
 }
@@ -67,7 +83,7 @@ Uint32 Timer_getTicks(Timer* self) {
         if (self->paused) {
             return self->pausedTicks;
         } else {
-            return SDL_GetTicks() - self->startTicks;
+            return Timer_now() - self->startTicks;
         }
     }
     return 0;
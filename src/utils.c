@@ -4,6 +4,7 @@
  */
 #include "utils.h"
 #include "app.h"
+#include "arena.h"
 #include "logger.h"
 
 Position* Position_new(const float x, const float y) {
@@ -17,6 +18,17 @@ Position* Position_new(const float x, const float y) {
     return pos;
 }
 
+Position* Position_newIn(Arena* arena, const float x, const float y) {
+    Position* pos = Arena_alloc(arena, sizeof(Position));
+    if (!pos) {
+        error("Failed to allocate arena memory for Position");
+        return NULL;
+    }
+    pos->x = x;
+    pos->y = y;
+    return pos;
+}
+
 void Position_destroy(Position* pos) {
     if (!pos) return;
     safe_free((void**)&pos);
@@ -97,6 +109,19 @@ Color* Color_rgba(const int r, const int g, const int b, const int a) {
     return color;
 }
 
+Color* Color_rgbaIn(Arena* arena, const int r, const int g, const int b, const int a) {
+    Color* color = Arena_alloc(arena, sizeof(Color));
+    if (!color) {
+        error("Failed to allocate arena memory for Color");
+        return NULL;
+    }
+    color->r = r;
+    color->g = g;
+    color->b = b;
+    color->a = a;
+    return color;
+}
+
 Color* Color_hsv(float h, float s, float v) {
     float dR, dG, dB;
     int r, g, b;
@@ -148,10 +173,7 @@ char* Strdup(const char* str) {
         error("Failed to allocate memory for string duplication");
         return NULL;
     }
-    for (size_t i = 0; i <= len; i++) {
-        copy[i] = str[i];
-    }
-    copy[len] = '\0';
+    memcpy(copy, str, len + 1);
     return copy;
 }
 
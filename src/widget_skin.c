@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "widget_skin.h"
+
+#include "framebuffer.h"
+#include "geometry.h"
+#include "logger.h"
+#include "render_queue.h"
+#include "style.h"
+#include "utils.h"
+
+VEC_DEFINE_NAMED(Vec_WidgetSkinCachePtr, WidgetSkinCache*)
+
+static Vec_WidgetSkinCachePtr caches;
+
+WidgetSkinCache* WidgetSkinCache_create(SDL_Renderer* renderer, ImageAtlas* atlas) {
+    if (!renderer) return NULL;
+    WidgetSkinCache* self = calloc(1, sizeof(WidgetSkinCache));
+    if (!self) {
+        error("Failed to allocate memory for WidgetSkinCache");
+        return NULL;
+    }
+    self->renderer = renderer;
+    self->atlas = atlas;
+    if (!Vec_WidgetSkinCachePtr_push(&caches, self)) {
+        safe_free((void**)&self);
+        return NULL;
+    }
+    return self;
+}
+
+void WidgetSkinCache_destroy(WidgetSkinCache* self) {
+    if (!self) return;
+    for (size_t i = 0; i < caches.size; i++) {
+        if (caches.data[i] == self) {
+            caches.data[i] = caches.data[--caches.size];
+            break;
+        }
+    }
+    if (caches.size == 0) {
+        Vec_WidgetSkinCachePtr_destroy(&caches);
+    }
+    for (size_t i = 0; i < self->skins.size; i++) {
+        if (self->skins.data[i].owned) {
+            SDL_DestroyTexture(self->skins.data[i].sprite.texture);
+        }
+    }
+    Vec_WidgetSkin_destroy(&self->skins);
+    safe_free((void**)&self);
+}
+
+WidgetSkinCache* WidgetSkinCache_get(SDL_Renderer* renderer) {
+    if (!renderer) return NULL;
+    for (size_t i = 0; i < caches.size; i++) {
+        if (caches.data[i]->renderer == renderer) {
+            return caches.data[i];
+        }
+    }
+    return NULL;
+}
+
+void WidgetSkinCache_logStats(WidgetSkinCache* self) {
+    if (!self) return;
+    size_t packed = 0;
+    for (size_t i = 0; i < self->skins.size; i++) {
+        packed += !self->skins.data[i].owned;
+    }
+    log_message(LOG_LEVEL_DEBUG, "Widget skins: %zu skins (%zu packed in the atlas), %zu draws", self->skins.size, packed, self->draws);
+}
+
+static SDL_Color WidgetSkin_color(const Color* color) {
+    if (!color) return (SDL_Color){ 0, 0, 0, 0 };
+    return (SDL_Color){ (Uint8)color->r, (Uint8)color->g, (Uint8)color->b, (Uint8)color->a };
+}
+
+// Whether (x, y) is inside the rect from (x0, y0) to (x1, y1) with corners rounded by radius
+static bool WidgetSkin_contains(float x, float y, float x0, float y0, float x1, float y1, float radius) {
+    if (x < x0 || x > x1 || y < y0 || y > y1) return false;
+    const float cx = x < x0 + radius ? x0 + radius : (x > x1 - radius ? x1 - radius : x);
+    const float cy = y < y0 + radius ? y0 + radius : (y > y1 - radius ? y1 - radius : y);
+    return (x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius;
+}
+
+// Coverage of the shadow shape, the widget outline moved by the offset, blurred along rows then columns
+static float* WidgetSkin_shadowCoverage(const WidgetSkin* skin, int width, int height) {
+    float* coverage = calloc((size_t)width * height, sizeof(float));
+    float* scratch = calloc((size_t)width * height, sizeof(float));
+    if (!coverage || !scratch) {
+        error("Failed to allocate memory for a widget shadow");
+        safe_free((void**)&coverage);
+        safe_free((void**)&scratch);
+        return NULL;
+    }
+    const float x0 = (float)(skin->left + skin->shadowOffsetX), y0 = (float)(skin->top + skin->shadowOffsetY);
+    const float x1 = x0 + (float)(skin->insetX * 2 + 1), y1 = y0 + (float)(skin->insetY * 2 + 1);
+    const float samples = WIDGET_SKIN_SAMPLES * WIDGET_SKIN_SAMPLES;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int inside = 0;
+            for (int s = 0; s < WIDGET_SKIN_SAMPLES * WIDGET_SKIN_SAMPLES; s++) {
+                const float sx = (float)x + ((float)(s % WIDGET_SKIN_SAMPLES) + 0.5f) / WIDGET_SKIN_SAMPLES;
+                const float sy = (float)y + ((float)(s / WIDGET_SKIN_SAMPLES) + 0.5f) / WIDGET_SKIN_SAMPLES;
+                inside += WidgetSkin_contains(sx, sy, x0, y0, x1, y1, (float)skin->cornerRadius);
+            }
+            coverage[(size_t)y * width + x] = (float)inside / samples;
+        }
+    }
+
+    // Gaussian of sigma blur / 2 cut at blur pixels, the sides leave room for all of it
+    const int radius = skin->shadowBlur;
+    float weights[WIDGET_SKIN_MAX_SHADOW * 2 + 1];
+    float total = 0.f;
+    for (int i = -radius; i <= radius; i++) {
+        const float d = radius > 0 ? (float)i / ((float)radius / 2.f) : 0.f;
+        weights[i + radius] = expf(-0.5f * d * d);
+        total += weights[i + radius];
+    }
+    for (int i = 0; i <= radius * 2; i++) {
+        weights[i] /= total;
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float sum = 0.f;
+            for (int i = -radius; i <= radius; i++) {
+                if (x + i >= 0 && x + i < width) sum += coverage[(size_t)y * width + x + i] * weights[i + radius];
+            }
+            scratch[(size_t)y * width + x] = sum;
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float sum = 0.f;
+            for (int i = -radius; i <= radius; i++) {
+                if (y + i >= 0 && y + i < height) sum += scratch[(size_t)(y + i) * width + x] * weights[i + radius];
+            }
+            coverage[(size_t)y * width + x] = sum;
+        }
+    }
+    safe_free((void**)&scratch);
+    return coverage;
+}
+
+// Border and fill of the skin with antialiased corners over its shadow, in straight alpha like the atlas pages
+static SDL_Surface* WidgetSkin_rasterize(const WidgetSkin* skin) {
+    const int width = skin->left + skin->insetX * 2 + 1 + skin->right;
+    const int height = skin->top + skin->insetY * 2 + 1 + skin->bottom;
+    SDL_Surface* surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
+        error("Failed to create widget skin surface : %s", SDL_GetError());
+        return NULL;
+    }
+    float* shadow = NULL;
+    if (skin->shadowColor.a > 0) {
+        shadow = WidgetSkin_shadowCoverage(skin, width, height);
+        if (!shadow) {
+            SDL_DestroySurface(surface);
+            return NULL;
+        }
+    }
+    const float x0 = (float)skin->left, y0 = (float)skin->top;
+    const float x1 = x0 + (float)(skin->insetX * 2 + 1), y1 = y0 + (float)(skin->insetY * 2 + 1);
+    const float outerRadius = (float)skin->cornerRadius;
+    const float border = (float)skin->borderWidth;
+    const float innerRadius = outerRadius > border ? outerRadius - border : 0.f;
+    const float fillAlpha = skin->background.a / 255.f;
+    const float borderAlpha = skin->border.a / 255.f;
+    const float shadowAlpha = skin->shadowColor.a / 255.f;
+    const float samples = WIDGET_SKIN_SAMPLES * WIDGET_SKIN_SAMPLES;
+    const SDL_Color background = skin->background, edgeColor = skin->border, shadowColor = skin->shadowColor;
+    for (int y = 0; y < height; y++) {
+        Uint8* row = (Uint8*)surface->pixels + (size_t)y * surface->pitch;
+        for (int x = 0; x < width; x++) {
+            int outer = 0, inner = 0;
+            for (int s = 0; s < WIDGET_SKIN_SAMPLES * WIDGET_SKIN_SAMPLES; s++) {
+                const float sx = (float)x + ((float)(s % WIDGET_SKIN_SAMPLES) + 0.5f) / WIDGET_SKIN_SAMPLES;
+                const float sy = (float)y + ((float)(s / WIDGET_SKIN_SAMPLES) + 0.5f) / WIDGET_SKIN_SAMPLES;
+                outer += WidgetSkin_contains(sx, sy, x0, y0, x1, y1, outerRadius);
+                inner += WidgetSkin_contains(sx, sy, x0 + border, y0 + border, x1 - border, y1 - border, innerRadius);
+            }
+            const float fill = fillAlpha * (float)inner / samples;
+            const float edge = borderAlpha * (float)(outer - inner) / samples;
+            // The shadow only shows where the widget doesn't cover it
+            const float under = shadow ? shadowAlpha * shadow[(size_t)y * width + x] * (1.f - fill - edge) : 0.f;
+            const float alpha = fill + edge + under;
+            Uint8* pixel = &row[x * 4];
+            pixel[0] = alpha > 0.f ? (Uint8)((background.r * fill + edgeColor.r * edge + shadowColor.r * under) / alpha + 0.5f) : 0;
+            pixel[1] = alpha > 0.f ? (Uint8)((background.g * fill + edgeColor.g * edge + shadowColor.g * under) / alpha + 0.5f) : 0;
+            pixel[2] = alpha > 0.f ? (Uint8)((background.b * fill + edgeColor.b * edge + shadowColor.b * under) / alpha + 0.5f) : 0;
+            pixel[3] = (Uint8)(alpha * 255.f + 0.5f);
+        }
+    }
+    safe_free((void**)&shadow);
+    return surface;
+}
+
+static bool WidgetSkin_build(WidgetSkinCache* self, WidgetSkin* skin) {
+    SDL_Surface* surface = WidgetSkin_rasterize(skin);
+    if (!surface) return false;
+    if (self->atlas && ImageAtlas_add(self->atlas, surface, &skin->sprite)) {
+        SDL_DestroySurface(surface);
+        return true;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(self->renderer, surface);
+    if (!texture) {
+        error("Failed to create widget skin texture : %s", SDL_GetError());
+        SDL_DestroySurface(surface);
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
+    Framebuffer_attachSurface(texture, surface, false, true);
+    skin->sprite = (Sprite){ texture, { 0, 0, (float)surface->w, (float)surface->h } };
+    skin->owned = true;
+    return true;
+}
+
+static const WidgetSkin* WidgetSkinCache_find(WidgetSkinCache* self, const WidgetSkin* key) {
+    for (size_t i = 0; i < self->skins.size; i++) {
+        const WidgetSkin* skin = &self->skins.data[i];
+        if (skin->borderWidth == key->borderWidth && skin->cornerRadius == key->cornerRadius
+            && memcmp(&skin->background, &key->background, sizeof(SDL_Color)) == 0 && memcmp(&skin->border, &key->border, sizeof(SDL_Color)) == 0
+            && memcmp(&skin->shadowColor, &key->shadowColor, sizeof(SDL_Color)) == 0 && skin->shadowOffsetX == key->shadowOffsetX
+            && skin->shadowOffsetY == key->shadowOffsetY && skin->shadowBlur == key->shadowBlur) {
+            return skin;
+        }
+    }
+    WidgetSkin skin = *key;
+    const int inset = skin.borderWidth > skin.cornerRadius ? skin.borderWidth : skin.cornerRadius;
+    skin.insetX = inset;
+    skin.insetY = inset;
+    if (skin.shadowColor.a > 0) {
+        // The shadow corner must end before the stretched middle on both sides, wherever the offset moves it
+        const int reachX = abs(skin.shadowOffsetX) + skin.cornerRadius + skin.shadowBlur;
+        const int reachY = abs(skin.shadowOffsetY) + skin.cornerRadius + skin.shadowBlur;
+        skin.insetX = reachX > inset ? reachX : inset;
+        skin.insetY = reachY > inset ? reachY : inset;
+        skin.left = skin.shadowBlur - skin.shadowOffsetX > 0 ? skin.shadowBlur - skin.shadowOffsetX : 0;
+        skin.right = skin.shadowBlur + skin.shadowOffsetX > 0 ? skin.shadowBlur + skin.shadowOffsetX : 0;
+        skin.top = skin.shadowBlur - skin.shadowOffsetY > 0 ? skin.shadowBlur - skin.shadowOffsetY : 0;
+        skin.bottom = skin.shadowBlur + skin.shadowOffsetY > 0 ? skin.shadowBlur + skin.shadowOffsetY : 0;
+    }
+    if (!WidgetSkin_build(self, &skin)) return NULL;
+    if (!Vec_WidgetSkin_push(&self->skins, skin)) {
+        if (skin.owned) {
+            SDL_DestroyTexture(skin.sprite.texture);
+        }
+        return NULL;
+    }
+    return &self->skins.data[self->skins.size - 1];
+}
+
+static int WidgetSkin_clamp(int value, int limit) {
+    return value < -limit ? -limit : (value > limit ? limit : value);
+}
+
+// Border strips around the fill, none of them overlapping
+static void WidgetSkin_drawRects(RenderQueue* queue, const SDL_FRect* rect, const Color* background, const Color* border, float borderWidth) {
+    if (border && borderWidth > 0) {
+        const SDL_FRect strips[4] = {
+            { rect->x, rect->y, rect->w, borderWidth },
+            { rect->x, rect->y + rect->h - borderWidth, rect->w, borderWidth },
+            { rect->x, rect->y + borderWidth, borderWidth, rect->h - borderWidth * 2 },
+            { rect->x + rect->w - borderWidth, rect->y + borderWidth, borderWidth, rect->h - borderWidth * 2 }
+        };
+        for (int i = 0; i < 4; i++) {
+            RenderQueue_fillRect(queue, &strips[i], border);
+        }
+    }
+    if (background) {
+        const SDL_FRect fill = { rect->x + borderWidth, rect->y + borderWidth, rect->w - borderWidth * 2, rect->h - borderWidth * 2 };
+        RenderQueue_fillRect(queue, &fill, background);
+    }
+}
+
+void WidgetSkin_draw(SDL_Renderer* renderer, const SDL_FRect* rect, const Color* background, const Color* border, int borderWidth, int cornerRadius,
+        const WidgetShadow* shadow) {
+    if (!renderer || !rect || rect->w <= 0 || rect->h <= 0) return;
+    RenderQueue* queue = RenderQueue_get(renderer);
+    if (borderWidth < 0) borderWidth = 0;
+    if (cornerRadius < 0) cornerRadius = 0;
+    if (borderWidth > WIDGET_SKIN_MAX_INSET) borderWidth = WIDGET_SKIN_MAX_INSET;
+    if (cornerRadius > WIDGET_SKIN_MAX_INSET) cornerRadius = WIDGET_SKIN_MAX_INSET;
+    const bool shadowed = shadow && shadow->color.a > 0;
+    const float half = (rect->w < rect->h ? rect->w : rect->h) / 2;
+    if ((!border || borderWidth == 0) && cornerRadius == 0 && !shadowed) {
+        if (background) {
+            RenderQueue_fillRect(queue, rect, background);
+        }
+        return;
+    }
+
+    WidgetSkinCache* self = WidgetSkinCache_get(renderer);
+    WidgetSkin key = { 0 };
+    key.background = WidgetSkin_color(background);
+    key.border = WidgetSkin_color(border);
+    key.borderWidth = borderWidth;
+    key.cornerRadius = cornerRadius;
+    if (shadowed) {
+        key.shadowColor = WidgetSkin_color(&shadow->color);
+        key.shadowOffsetX = WidgetSkin_clamp(shadow->offset_x, WIDGET_SKIN_MAX_SHADOW);
+        key.shadowOffsetY = WidgetSkin_clamp(shadow->offset_y, WIDGET_SKIN_MAX_SHADOW);
+        key.shadowBlur = shadow->blur > 0 ? WidgetSkin_clamp(shadow->blur, WIDGET_SKIN_MAX_SHADOW) : 0;
+    }
+    const WidgetSkin* skin = self ? WidgetSkinCache_find(self, &key) : NULL;
+    float textureWidth, textureHeight;
+    if (!skin || !SDL_GetTextureSize(skin->sprite.texture, &textureWidth, &textureHeight)) {
+        WidgetSkin_drawRects(queue, rect, background, border, (float)borderWidth < half ? (float)borderWidth : half);
+        return;
+    }
+
+    // Corners keep their size unless the widget is too small for them, then they shrink with their shadow
+    const float insetX = (float)skin->insetX, insetY = (float)skin->insetY;
+    const float fit = half / (insetX > insetY ? insetX : insetY);
+    const float scale = fit < 1.f ? fit : 1.f;
+    const float xs[4] = { rect->x - skin->left * scale, rect->x + insetX * scale, rect->x + rect->w - insetX * scale, rect->x + rect->w + skin->right * scale };
+    const float ys[4] = { rect->y - skin->top * scale, rect->y + insetY * scale, rect->y + rect->h - insetY * scale, rect->y + rect->h + skin->bottom * scale };
+    // The middle slices sample the center of their texel, linear filtering never reaches the corners
+    const SDL_FRect source = skin->sprite.source;
+    const float kx = (float)(skin->left + skin->insetX), ky = (float)(skin->top + skin->insetY);
+    const float us[6] = { source.x, source.x + kx, source.x + kx + 0.5f, source.x + kx + 0.5f, source.x + kx + 1, source.x + source.w };
+    const float vs[6] = { source.y, source.y + ky, source.y + ky + 0.5f, source.y + ky + 0.5f, source.y + ky + 1, source.y + source.h };
+    const SDL_FColor white = { 1, 1, 1, 1 };
+    SDL_Vertex vertices[9 * 4];
+    for (int row = 0; row < 3; row++) {
+        for (int column = 0; column < 3; column++) {
+            const float u0 = us[column * 2] / textureWidth, u1 = us[column * 2 + 1] / textureWidth;
+            const float v0 = vs[row * 2] / textureHeight, v1 = vs[row * 2 + 1] / textureHeight;
+            SDL_Vertex* quad = &vertices[(row * 3 + column) * 4];
+            quad[0] = (SDL_Vertex){ { xs[column], ys[row] }, white, { u0, v0 } };
+            quad[1] = (SDL_Vertex){ { xs[column + 1], ys[row] }, white, { u1, v0 } };
+            quad[2] = (SDL_Vertex){ { xs[column + 1], ys[row + 1] }, white, { u1, v1 } };
+            quad[3] = (SDL_Vertex){ { xs[column], ys[row + 1] }, white, { u0, v1 } };
+        }
+    }
+    const int* indices = Geometry_quadIndices(9);
+    if (!indices) return;
+    RenderQueue_geometry(queue, skin->sprite.texture, vertices, 9 * 4, indices, 9 * 6);
+    self->draws++;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Torisutan
+ * ALl rights reserved
+ */
+#include "worker_pool.h"
+
+#include "logger.h"
+#include "utils.h"
+
+static void WorkerPool_work(WorkerPool* self) {
+    for (;;) {
+        const int index = SDL_AddAtomicInt(&self->next, 1);
+        if (index >= self->count) return;
+        self->task(self->data, index);
+    }
+}
+
+static int WorkerPool_loop(void* data) {
+    WorkerPool* self = data;
+    int generation = 0;
+    SDL_LockMutex(self->mutex);
+    for (;;) {
+        while (!self->quit && self->generation == generation) {
+            SDL_WaitCondition(self->started, self->mutex);
+        }
+        if (self->quit) break;
+        generation = self->generation;
+        SDL_UnlockMutex(self->mutex);
+        WorkerPool_work(self);
+        SDL_LockMutex(self->mutex);
+        if (--self->busy == 0) {
+            SDL_SignalCondition(self->finished);
+        }
+    }
+    SDL_UnlockMutex(self->mutex);
+    return 0;
+}
+
+WorkerPool* WorkerPool_create(int threads) {
+    if (threads <= 0) {
+        threads = SDL_GetNumLogicalCPUCores();
+    }
+    WorkerPool* self = calloc(1, sizeof(WorkerPool));
+    if (!self) {
+        error("Failed to allocate memory for WorkerPool");
+        return NULL;
+    }
+    self->mutex = SDL_CreateMutex();
+    self->started = SDL_CreateCondition();
+    self->finished = SDL_CreateCondition();
+    self->threads = calloc(threads > 1 ? threads - 1 : 1, sizeof(SDL_Thread*));
+    if (!self->mutex || !self->started || !self->finished || !self->threads) {
+        error("Failed to create WorkerPool : %s", SDL_GetError());
+        WorkerPool_destroy(self);
+        return NULL;
+    }
+    for (int i = 0; i < threads - 1; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "worker %d", i + 1);
+        SDL_Thread* thread = SDL_CreateThread(WorkerPool_loop, name, self);
+        if (!thread) {
+            // Fewer workers still get the work done
+            error("Failed to create worker thread : %s", SDL_GetError());
+            break;
+        }
+        self->threads[self->threadCount++] = thread;
+    }
+    return self;
+}
+
+void WorkerPool_destroy(WorkerPool* self) {
+    if (!self) return;
+    if (self->mutex) {
+        SDL_LockMutex(self->mutex);
+        self->quit = true;
+        if (self->started) {
+            SDL_BroadcastCondition(self->started);
+        }
+        SDL_UnlockMutex(self->mutex);
+    }
+    for (int i = 0; i < self->threadCount; i++) {
+        SDL_WaitThread(self->threads[i], NULL);
+    }
+    safe_free((void**)&self->threads);
+    if (self->started) SDL_DestroyCondition(self->started);
+    if (self->finished) SDL_DestroyCondition(self->finished);
+    if (self->mutex) SDL_DestroyMutex(self->mutex);
+    safe_free((void**)&self);
+}
+
+int WorkerPool_size(const WorkerPool* self) {
+    return self ? self->threadCount + 1 : 1;
+}
+
+void WorkerPool_run(WorkerPool* self, int count, WorkerTask task, void* data) {
+    if (count <= 0 || !task) return;
+    if (!self || self->threadCount == 0 || count == 1) {
+        for (int i = 0; i < count; i++) {
+            task(data, i);
+        }
+        return;
+    }
+    SDL_LockMutex(self->mutex);
+    self->task = task;
+    self->data = data;
+    self->count = count;
+    SDL_SetAtomicInt(&self->next, 0);
+    self->busy = self->threadCount;
+    self->generation++;
+    SDL_BroadcastCondition(self->started);
+    SDL_UnlockMutex(self->mutex);
+
+    WorkerPool_work(self);
+
+    SDL_LockMutex(self->mutex);
+    while (self->busy > 0) {
+        SDL_WaitCondition(self->finished, self->mutex);
+    }
+    SDL_UnlockMutex(self->mutex);
+}